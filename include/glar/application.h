@@ -4,6 +4,7 @@
 #include <cstdint>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include <opencv2/aruco/charuco.hpp>
 
@@ -27,16 +28,25 @@ public:
 
   void Run();
 
+  // Composites the AR scene into every frame of a recorded video, once per worker count
+  void RunBatch(const std::string& inputFilepath, const std::string& outputFilepath, const std::vector<int>& workerCounts);
+
 private:
   void CreateDetectionMarker();
   void CreateCalibrationBoard();
 
+  // Called by window callbacks on input, so that the UI is redrawn
+  void Damage();
+
   uint32_t width_ = 640;
   uint32_t height_ = 480;
   GLFWwindow* window_ = nullptr;
 
   AppMode appMode_ = AppMode::DETECTION;
 
+  // Frames still to be drawn after the last input
+  int inputFrames_ = 0;
+
   cv::Ptr<cv::aruco::CharucoBoard> charucoBoard_;
 };
 }
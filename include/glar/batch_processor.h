@@ -0,0 +1,47 @@
+#ifndef GLAR_BATCH_PROCESSOR_H_
+#define GLAR_BATCH_PROCESSOR_H_
+
+#include <cstdint>
+#include <string>
+
+namespace glar
+{
+class Renderer;
+
+namespace vision
+{
+class MarkerDetector;
+}
+
+/**
+* Offline AR compositing of a recorded video
+*
+* Detection and pose estimation run on a pool of frame workers, while decoding, compositing and encoding stay on the
+* calling thread, which must own the GL context. Results are reassembled in frame order before compositing.
+*/
+class BatchProcessor
+{
+public:
+  struct Result
+  {
+    int workerCount = 0;
+    uint64_t frameCount = 0;
+    double seconds = 0.;
+
+    double Fps() const { return seconds > 0. ? frameCount / seconds : 0.; }
+  };
+
+public:
+  BatchProcessor() = delete;
+  BatchProcessor(const vision::MarkerDetector& detector, Renderer& renderer);
+  ~BatchProcessor();
+
+  Result Process(const std::string& inputFilepath, const std::string& outputFilepath, int workerCount);
+
+private:
+  const vision::MarkerDetector& detector_;
+  Renderer& renderer_;
+};
+}
+
+#endif // GLAR_BATCH_PROCESSOR_H_
@@ -0,0 +1,87 @@
+#ifndef GLAR_FRAME_RECORDER_H_
+#define GLAR_FRAME_RECORDER_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <opencv2/core.hpp>
+#include <opencv2/videoio.hpp>
+
+#include <glar/gl/pixel_pack_ring.h>
+#include <glar/util/mat_pool.h>
+
+namespace glar
+{
+/**
+* Records the default framebuffer into a video file without stalling rendering
+*
+* Frames are read back asynchronously through a ring of pixel pack buffers, and written by an encoder thread. The
+* video has a constant frame rate: frames are captured at most at that rate, and the last frame is repeated while
+* nothing is redrawn. Frames are dropped, and counted, when the readback ring or the encoder queue is full.
+*/
+class FrameRecorder
+{
+public:
+  struct Stats
+  {
+    uint64_t capturedCount = 0;
+    uint64_t writtenCount = 0; // Including repeated frames
+    uint64_t droppedCount = 0;
+  };
+
+public:
+  FrameRecorder() = delete;
+  FrameRecorder(const std::string& filepath, uint32_t width, uint32_t height, double fps = 30.);
+  ~FrameRecorder();
+
+  const std::string& Filepath() const { return filepath_; }
+  uint32_t Width() const { return readback_.Width(); }
+  uint32_t Height() const { return readback_.Height(); }
+
+  // Call after drawing a frame into the default framebuffer of the recorded size, before swapping
+  void Capture();
+
+  Stats stats() const;
+
+private:
+  struct Frame
+  {
+    cv::Mat image;
+    std::chrono::high_resolution_clock::time_point captureTime;
+  };
+
+  // Moves finished readbacks to the encoder
+  void Collect(bool wait);
+
+  void Encode();
+
+  std::string filepath_;
+  double fps_;
+
+  gl::PixelPackRing readback_;
+  std::deque<std::chrono::high_resolution_clock::time_point> readbackTimes_;
+  util::MatPool pool_;
+
+  std::chrono::high_resolution_clock::time_point startTime_;
+  uint64_t captureSlot_ = 0;
+
+  std::deque<Frame> queue_;
+  bool finished_ = false;
+  std::chrono::high_resolution_clock::time_point stopTime_;
+  std::mutex queueMutex_;
+  std::condition_variable queueCondition_;
+
+  Stats stats_;
+  mutable std::mutex statsMutex_;
+
+  cv::VideoWriter writer_;
+  std::thread encoder_;
+};
+}
+
+#endif // GLAR_FRAME_RECORDER_H_
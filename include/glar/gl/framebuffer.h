@@ -0,0 +1,53 @@
+#ifndef GLAR_GL_FRAMEBUFFER_H_
+#define GLAR_GL_FRAMEBUFFER_H_
+
+#include <cstdint>
+
+#include <glad/glad.h>
+
+namespace glar
+{
+namespace gl
+{
+/**
+* Offscreen render target with RGBA8 color texture and 24-bit depth texture
+*/
+class Framebuffer
+{
+public:
+  Framebuffer() = delete;
+  Framebuffer(uint32_t width, uint32_t height);
+  ~Framebuffer();
+
+  uint32_t Width() const { return width_; }
+  uint32_t Height() const { return height_; }
+
+  void Resize(uint32_t width, uint32_t height);
+
+  void Bind();
+  static void BindDefault();
+
+  // Binds for drawing, and clears color to transparent black and depth to 1 without changing the clear values of the context
+  void Clear();
+
+  void BindColorTexture(int index);
+  void BindDepthTexture(int index);
+
+  // Reads the color attachment, bottom row first
+  void ReadPixels(void* pixels, GLenum format);
+
+private:
+  void CreateAttachments();
+  void DestroyAttachments();
+
+  GLuint framebuffer_ = 0;
+  GLuint colorTexture_ = 0;
+  GLuint depthTexture_ = 0;
+
+  uint32_t width_ = 0;
+  uint32_t height_ = 0;
+};
+}
+}
+
+#endif // GLAR_GL_FRAMEBUFFER_H_
@@ -2,37 +2,39 @@
 #define GLAR_GL_GEOMETRY_H_
 
 #include <vector>
-#include <initializer_list>
 
 #include <glad/glad.h>
 
+#include <glar/gl/geometry_arena.h>
+
 namespace glar
 {
 namespace gl
 {
-struct Attribute
-{
-  int index;
-  int size;
-  int stride = 0; // With respect to float
-  int offset = 0; // With respect to float
-};
-
+/**
+* Static geometry in the buffers of an arena, with the vertex layout of the arena
+*
+* The arena must outlive its geometries.
+*/
 class Geometry
 {
 public:
   Geometry() = delete;
-  Geometry(const std::vector<float>& vertexBuffer, std::initializer_list<Attribute> attributes, const std::vector<uint32_t>& indexBuffer, GLenum drawMode);
+  Geometry(GeometryArena& arena, const std::vector<float>& vertexBuffer, const std::vector<uint32_t>& indexBuffer, GLenum drawMode);
   ~Geometry();
 
+  Geometry(const Geometry&) = delete;
+  Geometry& operator = (const Geometry&) = delete;
+
+  // For merged draws of many geometries with GeometryArena::Draw
+  const GeometryArena::Range& range() const { return range_; }
+
+  // Needs GeometryArena::Bind() of the arena
   void Draw();
 
 private:
-  GLuint buffers_[2] = { 0, }; // 0: vertex, 1: index
-  GLuint vao_ = 0;
-
-  GLenum drawMode_ = GL_TRIANGLES;
-  uint32_t elementCount_ = 0;
+  GeometryArena& arena_;
+  GeometryArena::Range range_;
 };
 }
 }
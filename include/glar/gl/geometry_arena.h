@@ -0,0 +1,110 @@
+#ifndef GLAR_GL_GEOMETRY_ARENA_H_
+#define GLAR_GL_GEOMETRY_ARENA_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <map>
+#include <vector>
+
+#include <glad/glad.h>
+
+namespace glar
+{
+namespace gl
+{
+struct Attribute
+{
+  int index;
+  int size;
+  int stride = 0; // With respect to float
+  int offset = 0; // With respect to float
+};
+
+/**
+* Vertex and index ranges of many geometries of the same vertex layout, suballocated from one vertex buffer and one
+* index buffer
+*
+* All geometries of the arena share one vertex array, so consecutive draws need no state changes, and draws of the
+* same mode are merged into multi-draw calls. Buffers are reallocated with twice the capacity when full.
+*/
+class GeometryArena
+{
+public:
+  struct Range
+  {
+    GLenum drawMode = GL_TRIANGLES;
+    uint32_t baseVertex = 0;
+    uint32_t vertexCount = 0;
+    uint32_t firstIndex = 0;
+    uint32_t indexCount = 0;
+  };
+
+public:
+  GeometryArena() = delete;
+
+  // Interleaved attributes, all with the same stride. Capacities in vertices and indices.
+  GeometryArena(std::initializer_list<Attribute> attributes, uint32_t vertexCapacity, uint32_t indexCapacity);
+  ~GeometryArena();
+
+  GeometryArena(const GeometryArena&) = delete;
+  GeometryArena& operator = (const GeometryArena&) = delete;
+
+  uint32_t vertexCapacity() const { return vertexRanges_.capacity(); }
+  uint32_t indexCapacity() const { return indexRanges_.capacity(); }
+
+  // Indices are relative to the first vertex of the geometry
+  Range Allocate(const std::vector<float>& vertexBuffer, const std::vector<uint32_t>& indexBuffer, GLenum drawMode);
+  void Free(const Range& range);
+
+  // Binds the shared vertex array once for all draws of a pass, and leaves it bound. Code that binds an element array
+  // buffer afterwards must bind its own vertex array first.
+  void Bind();
+
+  // Need Bind(). Ranges of the same draw mode are merged into one multi-draw call.
+  void Draw(const Range& range);
+  void Draw(const std::vector<Range>& ranges);
+
+private:
+  // First fit over free ranges, merged with their neighbors when freed
+  class RangeAllocator
+  {
+  public:
+    RangeAllocator() = delete;
+    explicit RangeAllocator(uint32_t capacity);
+
+    uint32_t capacity() const { return capacity_; }
+
+    bool Allocate(uint32_t size, uint32_t& offset);
+    void Free(uint32_t offset, uint32_t size);
+    void Grow(uint32_t capacity);
+
+  private:
+    // Offset to size
+    std::map<uint32_t, uint32_t> free_;
+    uint32_t capacity_ = 0;
+  };
+
+  static GLuint CreateBuffer(size_t size);
+
+  // Copies the contents to a new buffer of the capacity, and attaches it to the vertex array
+  void GrowVertexBuffer(uint32_t capacity);
+  void GrowIndexBuffer(uint32_t capacity);
+
+  GLuint vao_ = 0;
+  GLuint vertexBuffer_ = 0;
+  GLuint indexBuffer_ = 0;
+  uint32_t vertexSize_ = 0; // In floats
+
+  RangeAllocator vertexRanges_;
+  RangeAllocator indexRanges_;
+
+  // Multi-draw arguments, kept to not allocate on every draw
+  std::vector<GLsizei> drawCounts_;
+  std::vector<const void*> drawOffsets_;
+  std::vector<GLint> drawBaseVertices_;
+};
+}
+}
+
+#endif // GLAR_GL_GEOMETRY_ARENA_H_
@@ -0,0 +1,59 @@
+#ifndef GLAR_GL_PIXEL_PACK_RING_H_
+#define GLAR_GL_PIXEL_PACK_RING_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <glad/glad.h>
+
+namespace glar
+{
+namespace gl
+{
+/**
+* Asynchronous framebuffer readback through a ring of pixel pack buffers
+*
+* Read() only queues the copy into the next buffer and fences it, and Take() copies out the oldest read once its fence
+* is signaled, so neither waits for the GPU. Pixels are tightly packed BGR, bottom row first.
+*/
+class PixelPackRing
+{
+public:
+  PixelPackRing() = delete;
+  PixelPackRing(uint32_t width, uint32_t height, int bufferCount = 3);
+  ~PixelPackRing();
+
+  PixelPackRing(const PixelPackRing&) = delete;
+  PixelPackRing& operator = (const PixelPackRing&) = delete;
+
+  uint32_t Width() const { return width_; }
+  uint32_t Height() const { return height_; }
+  size_t FrameSize() const { return static_cast<size_t>(width_) * height_ * 3; }
+
+  int PendingCount() const { return pendingCount_; }
+
+  // Reads the framebuffer bound for reading. False when every buffer still holds a read not taken yet.
+  bool Read();
+
+  // Copies the oldest read into pixels of FrameSize(). False when there is none, or it is not finished and wait is false.
+  bool Take(void* pixels, bool wait = false);
+
+private:
+  struct Slot
+  {
+    GLuint buffer = 0;
+    GLsync fence = nullptr;
+  };
+
+  uint32_t width_;
+  uint32_t height_;
+
+  std::vector<Slot> slots_;
+  int next_ = 0;
+  int pendingCount_ = 0;
+};
+}
+}
+
+#endif // GLAR_GL_PIXEL_PACK_RING_H_
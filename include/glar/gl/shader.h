@@ -1,6 +1,7 @@
 #ifndef GLAR_GL_SHADER_H_
 #define GLAR_GL_SHADER_H_
 
+#include <cstdint>
 #include <string>
 
 #include <glad/glad.h>
@@ -15,14 +16,19 @@ class Shader
 {
 public:
   Shader() = delete;
+
+  // Compute shader program if [name].comp exists, otherwise [name].vert, [name].frag and optional [name].geom
   Shader(const std::string& dirpath, const std::string& name);
   ~Shader();
 
   void Use();
   void UniformMatrix4f(const std::string& name, const glm::mat4& m);
   void UniformMatrix3f(const std::string& name, const glm::mat3& m);
+  void Uniform2f(const std::string& name, const glm::vec2& v);
   void Uniform4f(const std::string& name, const glm::vec4& v);
   void Uniform1i(const std::string& name, int value);
+  void Uniform1ui(const std::string& name, uint32_t value);
+  void Uniform1f(const std::string& name, float value);
 
 private:
   GLuint program_ = 0;
@@ -0,0 +1,60 @@
+#ifndef GLAR_GL_STREAM_BUFFER_H_
+#define GLAR_GL_STREAM_BUFFER_H_
+
+#include <cstddef>
+#include <vector>
+
+#include <glad/glad.h>
+
+namespace glar
+{
+namespace gl
+{
+/**
+* Buffer for per-frame data, split into a ring of partitions
+*
+* The CPU writes the next partition while the GPU may still read the previous ones, and every partition is guarded by a
+* fence placed after its last draw. With GL 4.4 the buffer is created with glBufferStorage and mapped persistently and
+* coherently once; otherwise each partition is mapped unsynchronized on every Map().
+*/
+class StreamBuffer
+{
+public:
+  StreamBuffer() = delete;
+  StreamBuffer(size_t partitionSize, int partitionCount = 3);
+  ~StreamBuffer();
+
+  StreamBuffer(const StreamBuffer&) = delete;
+  StreamBuffer& operator = (const StreamBuffer&) = delete;
+
+  GLuint Buffer() const { return buffer_; }
+  bool Persistent() const { return persistentData_ != nullptr; }
+
+  size_t PartitionSize() const { return partitionSize_; }
+  int PartitionCount() const { return static_cast<int>(fences_.size()); }
+  int Partition() const { return partition_; }
+  size_t PartitionOffset() const { return partition_ * partitionSize_; }
+
+  // Moves to the next partition, waits until the GPU is done reading it and returns its memory for writing
+  void* Map();
+
+  // Publishes the writes to the current partition
+  void Unmap();
+
+  // Call after the draw commands reading the current partition
+  void Fence();
+
+private:
+  GLuint buffer_ = 0;
+  size_t partitionSize_ = 0;
+
+  int partition_ = 0;
+  std::vector<GLsync> fences_;
+
+  char* persistentData_ = nullptr;
+  bool mapped_ = false;
+};
+}
+}
+
+#endif // GLAR_GL_STREAM_BUFFER_H_
@@ -11,23 +11,41 @@ namespace gl
 {
 class Texture
 {
+public:
+  enum class Format
+  {
+    RGB,
+    // Y, U and V planes in separate single-channel textures, the chroma planes at half resolution
+    I420,
+  };
+
 public:
   Texture();
-  Texture(uint32_t width, uint32_t height);
+  Texture(uint32_t width, uint32_t height, Format format = Format::RGB);
   ~Texture();
 
   bool Valid() const;
+  uint32_t Width() const { return width_; }
+  uint32_t Height() const { return height_; }
+  Format format() const { return format_; }
 
   void Bind();
+  // I420 planes are bound to index, index + 1 and index + 2
   void Bind(int index);
 
-  void UpdateStorage(uint32_t width, uint32_t height);
+  void UpdateStorage(uint32_t width, uint32_t height, Format format = Format::RGB);
   void Update(void* pixels, GLenum format);
+  // Contiguous Y, U and V planes
+  void UpdateI420(const void* pixels);
 
 private:
+  void Delete();
+
   GLuint texture_ = 0;
+  GLuint chromaTextures_[2] = {};
   uint32_t width_ = 0;
   uint32_t height_ = 0;
+  Format format_ = Format::RGB;
 };
 }
 }
@@ -0,0 +1,144 @@
+#ifndef GLAR_IPC_POSE_CHANNEL_H_
+#define GLAR_IPC_POSE_CHANNEL_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#include <glar/util/seqlock.h>
+
+namespace glar
+{
+namespace ipc
+{
+/**
+* Shared memory layout of marker poses and frames published by glar
+*
+* [ChannelHeader][PoseSlot x poseSlotCount][FrameSlot + frame data x frameSlotCount]
+*
+* Poses are a ring of records with consecutive sequence numbers, frames are a few slots written round-robin.
+* There is one publisher and any number of readers, none of which ever block each other.
+*/
+constexpr uint32_t channelMagic = 0x474C4152; // "GLAR"
+constexpr uint32_t channelVersion = 1;
+
+constexpr const char* defaultChannelName = "glar_poses";
+
+// Timestamps are nanoseconds of the steady clock, which is shared by all processes of a machine
+using Clock = std::chrono::steady_clock;
+
+inline int64_t Timestamp(Clock::time_point time)
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+}
+
+inline int64_t Now()
+{
+  return Timestamp(Clock::now());
+}
+
+struct PoseRecord
+{
+  uint64_t sequence = 0;
+
+  // Sequence of the published frame the pose was detected in, ~0 if the frame is not published
+  uint64_t frameSequence = ~0ull;
+
+  int64_t captureTime = 0;
+  int64_t publishTime = 0;
+
+  uint32_t stream = 0;
+  int32_t markerId = 0;
+
+  // Marker to camera transform in OpenCV camera coordinates, Rodrigues rotation and translation in meters
+  double rvec[3] = {};
+  double tvec[3] = {};
+};
+
+enum class FrameFormat : uint32_t
+{
+  BGR,
+  // Y plane followed by U and V planes at half resolution
+  I420,
+};
+
+struct FrameInfo
+{
+  uint64_t sequence = 0;
+
+  int64_t captureTime = 0;
+  int64_t publishTime = 0;
+
+  uint32_t stream = 0;
+  FrameFormat format = FrameFormat::BGR;
+  uint32_t width = 0;
+  uint32_t height = 0;
+
+  // Tightly packed rows
+  uint64_t size = 0;
+};
+
+struct ChannelHeader
+{
+  // Written last by the publisher, after the rest of the layout is initialized
+  std::atomic<uint32_t> magic;
+  uint32_t version;
+
+  uint32_t poseSlotCount;
+  uint32_t frameSlotCount;
+  uint64_t frameCapacity;
+
+  // Published counts, the newest pose is poseCount - 1
+  alignas(64) std::atomic<uint64_t> poseCount;
+  alignas(64) std::atomic<uint64_t> frameCount;
+};
+
+// Shared atomics must be lock-free to be address-free
+inline bool IsLockFree(const ChannelHeader& header)
+{
+  return header.magic.is_lock_free() && header.poseCount.is_lock_free();
+}
+
+using PoseSlot = util::SeqLock<PoseRecord>;
+
+struct FrameSlot
+{
+  // Odd while the frame data is written
+  std::atomic<uint64_t> version;
+  util::SeqLock<FrameInfo> info;
+};
+
+constexpr size_t AlignUp(size_t size, size_t alignment = 64)
+{
+  return (size + alignment - 1) / alignment * alignment;
+}
+
+constexpr size_t PoseSlotsOffset()
+{
+  return AlignUp(sizeof(ChannelHeader));
+}
+
+constexpr size_t FrameSlotsOffset(uint32_t poseSlotCount)
+{
+  return PoseSlotsOffset() + AlignUp(sizeof(PoseSlot) * poseSlotCount);
+}
+
+constexpr size_t FrameDataOffset()
+{
+  return AlignUp(sizeof(FrameSlot));
+}
+
+constexpr size_t FrameSlotStride(uint64_t frameCapacity)
+{
+  return FrameDataOffset() + AlignUp(frameCapacity);
+}
+
+constexpr size_t ChannelSize(uint32_t poseSlotCount, uint32_t frameSlotCount, uint64_t frameCapacity)
+{
+  return FrameSlotsOffset(poseSlotCount) + frameSlotCount * FrameSlotStride(frameCapacity);
+}
+}
+}
+
+#endif // GLAR_IPC_POSE_CHANNEL_H_
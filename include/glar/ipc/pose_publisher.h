@@ -0,0 +1,74 @@
+#ifndef GLAR_IPC_POSE_PUBLISHER_H_
+#define GLAR_IPC_POSE_PUBLISHER_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include <glar/ipc/pose_channel.h>
+#include <glar/util/shared_memory.h>
+
+namespace glar
+{
+namespace ipc
+{
+/**
+* Writes marker poses, and optionally frames, to a shared memory channel read by other processes
+*
+* Publishing never waits for readers. Readers that fall behind by more than the ring size lose the oldest poses.
+* Calls must be serialized by the caller.
+*/
+class PosePublisher
+{
+public:
+  struct CreateInfo
+  {
+    std::string name = defaultChannelName;
+
+    uint32_t poseSlotCount = 4096;
+
+    // Frames are not published with frame capacity 0
+    uint32_t frameSlotCount = 3;
+    uint64_t frameCapacity = 0;
+  };
+
+  struct Stats
+  {
+    uint64_t poseCount = 0;
+    uint64_t frameCount = 0;
+
+    // Frames larger than the frame capacity, not published
+    uint64_t oversizedFrameCount = 0;
+  };
+
+public:
+  PosePublisher() = delete;
+  explicit PosePublisher(const CreateInfo& createInfo);
+  ~PosePublisher();
+
+  const std::string& name() const { return createInfo_.name; }
+  const Stats& stats() const { return stats_; }
+
+  bool PublishesFrames() const;
+
+  // Sequence and publish time are filled in. Returns the sequence of the pose.
+  uint64_t PublishPose(PoseRecord record);
+
+  // Sequence and publish time are filled in. Returns the sequence of the frame, or ~0 if it is not published.
+  uint64_t PublishFrame(FrameInfo info, const void* data);
+
+private:
+  FrameSlot& frameSlot(uint64_t index);
+
+  CreateInfo createInfo_;
+  Stats stats_;
+
+  std::unique_ptr<util::SharedMemory> memory_;
+  ChannelHeader* header_ = nullptr;
+  PoseSlot* poseSlots_ = nullptr;
+  uint8_t* frameSlots_ = nullptr;
+};
+}
+}
+
+#endif // GLAR_IPC_POSE_PUBLISHER_H_
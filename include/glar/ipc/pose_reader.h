@@ -0,0 +1,73 @@
+#ifndef GLAR_IPC_POSE_READER_H_
+#define GLAR_IPC_POSE_READER_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include <glar/ipc/pose_channel.h>
+#include <glar/util/shared_memory.h>
+
+namespace glar
+{
+namespace ipc
+{
+/**
+* Reads the marker poses and frames of a PosePublisher in another process
+*
+* Readers never write to the channel, so any number of them can follow it at their own pace. Depends only on the
+* standard library, to be linked into consumers other than glar.
+*/
+class PoseReader
+{
+public:
+  // Frame data in shared memory, without a copy
+  struct FrameView
+  {
+    FrameInfo info;
+    const uint8_t* data = nullptr;
+
+    uint32_t slot = 0;
+    uint64_t slotVersion = 0;
+  };
+
+public:
+  PoseReader() = delete;
+
+  // Throws if the channel is not published. Reading starts at the newest pose.
+  explicit PoseReader(const std::string& name = defaultChannelName);
+
+  // False once the publisher is gone. A new publisher of the same name is followed by opening a new reader.
+  bool Connected() const;
+
+  bool HasFrames() const { return header_->frameSlotCount > 0; }
+
+  // Next pose after the last one read, returns false if there is none yet.
+  // A reader that fell behind by more than the ring size continues at the oldest pose still in the ring.
+  bool Next(PoseRecord& record);
+
+  // Poses overwritten before they were read
+  uint64_t droppedCount() const { return droppedCount_; }
+
+  // Newest frame, returns false if there is none yet or it is being overwritten
+  bool LatestFrame(FrameView& frame) const;
+
+  // True while the frame data has not started to be overwritten. Check after using the data, and drop the
+  // results if it turns false.
+  bool Valid(const FrameView& frame) const;
+
+private:
+  const FrameSlot& frameSlot(uint32_t slot) const;
+
+  std::unique_ptr<util::SharedMemory> memory_;
+  const ChannelHeader* header_ = nullptr;
+  const PoseSlot* poseSlots_ = nullptr;
+  const uint8_t* frameSlots_ = nullptr;
+
+  uint64_t next_ = 0;
+  uint64_t droppedCount_ = 0;
+};
+}
+}
+
+#endif // GLAR_IPC_POSE_READER_H_
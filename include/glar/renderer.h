@@ -0,0 +1,89 @@
+#ifndef GLAR_RENDERER_H_
+#define GLAR_RENDERER_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include <glm/glm.hpp>
+
+#include <glar/gl/framebuffer.h>
+#include <glar/gl/geometry.h>
+#include <glar/gl/shader.h>
+#include <glar/gl/texture.h>
+#include <glar/scene/fractal.h>
+#include <glar/scene/fractal_geometry.h>
+#include <glar/scene/fractal_compute_geometry.h>
+
+namespace glar
+{
+/**
+* Draws the camera image and the augmented scene into the current viewport
+*/
+class Renderer
+{
+public:
+  enum class FractalBackend
+  {
+    CPU,
+    GPU,
+  };
+
+public:
+  Renderer() = delete;
+  Renderer(const std::string& shaderDirpath, std::unique_ptr<scene::Fractal> fractal);
+  ~Renderer();
+
+  // GPU backend is created on first use
+  void SetFractalBackend(FractalBackend backend);
+
+  // Keyframe cache of the CPU backend, keyframe count 0 disables it
+  void SetFractalKeyframes(const scene::FractalKeyframes::CreateInfo& createInfo);
+  const scene::FractalKeyframes* fractalKeyframes() const;
+  const scene::FractalKeyframes::Stats* fractalKeyframeStats() const;
+
+  // Simulation thread of the CPU backend, time step 0 generates meshes in UpdateAnimation()
+  void SetFractalSimulation(const scene::FractalSimulation::CreateInfo& createInfo);
+
+  // Vertices per tube ring, one of FractalMesh::ringSizes. Recreates the fractal geometries, keeping the keyframe and
+  // simulation settings.
+  void SetFractalRingSize(int ringSize);
+  int fractalRingSize() const { return fractalGeometry_->ringSize(); }
+
+  void UpdateAnimation(float animationTime);
+
+  // Fraction of the viewport resolution the augmented scene is rendered at. Below 1, it is rendered offscreen and
+  // upsampled over the camera image, trading sharpness for fragment cost.
+  void SetOverlayScale(float scale);
+  float overlayScale() const { return overlayScale_; }
+
+  void DrawCamera(gl::Texture& cameraTexture);
+  void DrawAugment(const glm::mat4& model, const glm::mat3& intrinsic, uint32_t width, uint32_t height);
+
+private:
+  void DrawScene(const glm::mat4& model, const glm::mat3& intrinsic, uint32_t width, uint32_t height);
+  void CompositeOverlay();
+
+  std::string shaderDirpath_;
+
+  gl::Shader cameraShader_;
+  gl::Shader colorShader_;
+  gl::Shader phongShader_;
+  gl::Shader overlayShader_;
+
+  // Declared before its geometries, which free their ranges on destruction
+  gl::GeometryArena geometryArena_;
+  gl::Geometry rectGeometry_;
+  gl::Geometry axisGeometry_;
+
+  std::unique_ptr<scene::Fractal> fractal_;
+  std::unique_ptr<scene::FractalGeometry> fractalGeometry_;
+  std::unique_ptr<scene::FractalComputeGeometry> fractalComputeGeometry_;
+  FractalBackend fractalBackend_ = FractalBackend::CPU;
+
+  float overlayScale_ = 1.f;
+  std::unique_ptr<gl::Framebuffer> overlayFramebuffer_;
+};
+}
+
+#endif // GLAR_RENDERER_H_
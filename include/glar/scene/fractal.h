@@ -1,12 +1,20 @@
 #ifndef GLAR_SCENE_FRACTAL_H_
 #define GLAR_SCENE_FRACTAL_H_
 
+#include <cstdint>
+#include <memory>
+#include <string>
 #include <vector>
 
 #include <glm/glm.hpp>
 
 namespace glar
 {
+namespace util
+{
+class MappedFile;
+}
+
 namespace scene
 {
 class Fractal
@@ -32,36 +40,87 @@ public:
     float lateralAngleBegin = pi / 3.f;
     float lateralAngleEnd = pi * 2.f / 3.f;
     float curveAngle = pi * 3.f / 4.f;
+
+    // Budget, 0 for unlimited. Earlier branches are grown first until either one is reached.
+    uint32_t maxCurveCount = 0;
+    uint32_t maxTriangleCount = 0; // Of meshes with any of FractalMesh::ringSizes
   };
 
+  // Plain data, stored as is in cache files
   struct Curve
   {
-  public:
-    Curve(const CreateInfo& createInfo);
-
-    const auto& info() const { return createInfo_; }
-
     glm::mat4 base = glm::mat4(1.f);
     float startOffset = 0.f;
     float blossomAngles[2] = { 0.f, 0.f };
+  };
+
+  // Curves of either a generated or a memory-mapped fractal
+  class Curves
+  {
+  public:
+    Curves() = default;
+    Curves(const Curve* data, size_t size) : data_(data), size_(size) {}
+
+    const Curve* begin() const { return data_; }
+    const Curve* end() const { return data_ + size_; }
+    const Curve& operator [] (size_t index) const { return data_[index]; }
+    const Curve* data() const { return data_; }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
 
   private:
-    const CreateInfo& createInfo_;
+    const Curve* data_ = nullptr;
+    size_t size_ = 0;
   };
 
 public:
   Fractal() = delete;
   explicit Fractal(const CreateInfo& createInfo);
+  // The same seed and parameters give the same tree for any thread count, 0 for the hardware concurrency
+  Fractal(const CreateInfo& createInfo, uint32_t seed, int threadCount = 0);
+
+  // Maps a cache file written by Save(), throws if the file is not a valid cache
+  explicit Fractal(const std::string& cacheFilepath);
+
   ~Fractal();
 
+  // Loads the cache if it was created with the same parameters and seed, otherwise creates a fractal and writes the cache
+  static std::unique_ptr<Fractal> LoadOrCreate(const std::string& cacheFilepath, const CreateInfo& createInfo, uint32_t seed);
+
   const auto& info() const { return createInfo_; }
-  const auto& curves() const { return curves_; }
+  uint32_t seed() const { return seed_; }
+  Curves curves() const { return curves_; }
+
+  // Cumulative transforms of whole steps along a curve, element i for i steps from the curve base
+  const std::vector<glm::mat4>& stepTransforms() const { return stepTransforms_; }
+
+  void Save(const std::string& filepath) const;
 
 private:
-  void CreateCurve(float startOffset, const glm::mat4& transform);
+  struct Division
+  {
+    float startOffset;
+    glm::mat4 transform;
+
+    // Random values of a curve are keyed by its path of division indices from the root, hashed
+    uint64_t path;
+  };
+
+  void CreateStepTransforms();
+  void CreateCurves(int threadCount);
+  // Depends only on the division and the seed, so curves are created on any thread
+  void CreateCurve(const Division& division, Curve& curve, std::vector<Division>& divisions) const;
 
   CreateInfo createInfo_;
-  std::vector<Curve> curves_;
+  uint32_t seed_ = 0;
+
+  Curves curves_;
+
+  // Either one is the storage of curves_
+  std::vector<Curve> curveStorage_;
+  std::unique_ptr<util::MappedFile> cacheFile_;
+
+  std::vector<glm::mat4> stepTransforms_;
 };
 }
 }
@@ -0,0 +1,47 @@
+#ifndef GLAR_SCENE_FRACTAL_COMPUTE_GEOMETRY_H_
+#define GLAR_SCENE_FRACTAL_COMPUTE_GEOMETRY_H_
+
+#include <string>
+
+#include <glad/glad.h>
+
+#include <glar/gl/shader.h>
+#include <glar/scene/fractal.h>
+#include <glar/scene/fractal_mesh.h>
+
+namespace glar
+{
+namespace scene
+{
+/**
+* Fractal mesh generated on the GPU
+*
+* Curves are uploaded once to a shader storage buffer. Every update, a compute shader writes vertices and indices for
+* the animation time directly into the draw buffers, reserving output ranges with atomic counters that double as the
+* indirect draw command.
+*/
+class FractalComputeGeometry
+{
+public:
+  FractalComputeGeometry() = delete;
+  FractalComputeGeometry(const Fractal& fractal, const std::string& shaderDirpath, int ringSize = FractalMesh::defaultRingSize);
+  ~FractalComputeGeometry();
+
+  void UpdateAnimation(float animationTime);
+  void Draw();
+
+  int ringSize() const { return ringSize_; }
+
+private:
+  const Fractal& fractal_;
+  int ringSize_ = FractalMesh::defaultRingSize;
+
+  gl::Shader computeShader_;
+
+  GLuint vao_ = 0;
+  GLuint buffers_[4] = { 0, }; // 0: vertex, 1: index, 2: curve, 3: indirect command
+};
+}
+}
+
+#endif // GLAR_SCENE_FRACTAL_COMPUTE_GEOMETRY_H_
@@ -1,37 +1,71 @@
 #ifndef GLAR_SCENE_FRACTAL_GEOMETRY_H_
 #define GLAR_SCENE_FRACTAL_GEOMETRY_H_
 
+#include <memory>
+
 #include <glad/glad.h>
 
+#include <glar/gl/stream_buffer.h>
 #include <glar/scene/fractal.h>
+#include <glar/scene/fractal_keyframes.h>
+#include <glar/scene/fractal_mesh.h>
+#include <glar/scene/fractal_simulation.h>
 
 namespace glar
 {
 namespace scene
 {
+/**
+* Fractal mesh generated on the CPU every update
+*
+* Each update is written into the next partition of a stream buffer, laid out as vertices followed by indices, while
+* the GPU may still draw from the previous partitions. Updates are served from a keyframe cache when it is enabled.
+*
+* With a simulation, meshes are generated on the simulation thread and updates only copy the newest one into the
+* stream buffer.
+*/
 class FractalGeometry
 {
 public:
   FractalGeometry() = delete;
-  explicit FractalGeometry(const Fractal& fractal);
+  explicit FractalGeometry(const Fractal& fractal, int ringSize = FractalMesh::defaultRingSize);
   ~FractalGeometry();
 
+  // Keyframe count 0 disables the cache
+  void SetKeyframes(const FractalKeyframes::CreateInfo& createInfo);
+  const FractalKeyframes* keyframes() const { return keyframes_.get(); }
+
+  // Stats as of the mesh drawn, nullptr without keyframe cache
+  const FractalKeyframes::Stats* keyframeStats() const { return keyframes_ ? &keyframeStats_ : nullptr; }
+
+  // Time step 0 generates meshes on the calling thread
+  void SetSimulation(const FractalSimulation::CreateInfo& createInfo);
+  const FractalSimulation* simulation() const { return simulation_.get(); }
+
+  int ringSize() const { return mesh_.ringSize(); }
+
   void UpdateAnimation(float animationTime);
   void Draw();
 
 private:
-  void AppendToBuffer(const Fractal::Curve& curve, float animationTime);
+  static size_t PartitionSize(const FractalMesh& mesh);
 
-  const Fractal& fractal_;
+  void Upload(const FractalSimulation::Frame& frame);
+
+  FractalMesh mesh_;
+  std::unique_ptr<FractalKeyframes> keyframes_;
+  FractalKeyframes::Stats keyframeStats_;
+
+  // Destroyed before the keyframes it uses
+  std::unique_ptr<FractalSimulation> simulation_;
 
   GLuint vao_;
-  GLuint buffers_[2];
+  gl::StreamBuffer buffer_;
 
-  uint32_t indexCount_ = 0;
+  // Byte size of the vertex part of a partition, a multiple of vertex size
+  size_t vertexBytes_ = 0;
 
-  // Intermediates for updating buffers
-  std::vector<float> vertexBuffer_;
-  std::vector<unsigned int> indexBuffer_;
+  uint32_t indexCount_ = 0;
 };
 }
 }
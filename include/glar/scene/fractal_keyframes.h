@@ -0,0 +1,87 @@
+#ifndef GLAR_SCENE_FRACTAL_KEYFRAMES_H_
+#define GLAR_SCENE_FRACTAL_KEYFRAMES_H_
+
+#include <cstdint>
+#include <vector>
+
+#include <glar/scene/fractal_mesh.h>
+
+namespace glar
+{
+namespace scene
+{
+/**
+* Packed fractal meshes at evenly spaced times of the periodic growth animation
+*
+* Keyframes are generated on first use and kept while the memory limit allows. The animation is symmetric in time,
+* so keyframes k and N - k share storage. Frames are served from the nearest keyframe, or interpolated between
+* neighboring keyframes of the same topology.
+*/
+class FractalKeyframes
+{
+public:
+  struct CreateInfo
+  {
+    int keyframeCount = 120; // Per period
+    size_t memoryLimit = 256 * 1024 * 1024;
+    bool interpolate = false;
+  };
+
+  struct Stats
+  {
+    int keyframeCount = 0;
+    int storedCount = 0;
+    size_t memoryUsage = 0;
+    size_t memoryLimit = 0;
+
+    uint64_t hitCount = 0;
+    uint64_t interpolatedCount = 0;
+    uint64_t missCount = 0; // Generated, not stored
+  };
+
+public:
+  FractalKeyframes() = delete;
+  FractalKeyframes(const FractalMesh& mesh, const CreateInfo& createInfo);
+
+  const auto& info() const { return createInfo_; }
+  const auto& stats() const { return stats_; }
+
+  // Same as FractalMesh::Generate(), but from keyframes when possible
+  FractalMesh::Counts Generate(float animationTime, float* vertices, uint32_t* indices);
+
+private:
+  struct Keyframe
+  {
+    bool generated = false;
+    bool stored = false;
+    std::vector<float> vertices;
+    std::vector<uint32_t> indices;
+
+    // Whether vertices can be interpolated with the next stored keyframe
+    bool sameTopologyAsNext = false;
+  };
+
+  // Generated on first use, nullptr when the memory limit is reached
+  const Keyframe* Get(int index);
+
+  int StorageIndex(int index) const;
+  FractalMesh::Counts Copy(const Keyframe& keyframe, float* vertices, uint32_t* indices) const;
+
+  const FractalMesh& mesh_;
+  CreateInfo createInfo_;
+  Stats stats_;
+
+  std::vector<Keyframe> keyframes_;
+
+  // Generation target before copying into a keyframe of the exact size
+  std::vector<float> scratchVertices_;
+  std::vector<uint32_t> scratchIndices_;
+
+  // Keyframe generated into scratch memory during the current Generate(), served as is if not stored
+  int scratchStorageIndex_ = -1;
+  FractalMesh::Counts scratchCounts_;
+};
+}
+}
+
+#endif // GLAR_SCENE_FRACTAL_KEYFRAMES_H_
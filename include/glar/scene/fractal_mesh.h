@@ -0,0 +1,68 @@
+#ifndef GLAR_SCENE_FRACTAL_MESH_H_
+#define GLAR_SCENE_FRACTAL_MESH_H_
+
+#include <cstdint>
+#include <vector>
+
+#include <glar/scene/fractal.h>
+
+namespace glar
+{
+namespace scene
+{
+/**
+* Animated fractal mesh built on the CPU
+*
+* Writes vertices and indices straight into caller memory, typically a mapped GL buffer, so no intermediate copy is made.
+* Vertices are 3 floats for position followed by 3 floats for color, and indices start from 0.
+*
+* Curves are tubes of rings of a few fixed sizes, each generated by its own instantiation of the tube kernel.
+*/
+class FractalMesh
+{
+public:
+  static constexpr int vertexSize = 6;
+
+  // Growth animation repeats with this period in seconds
+  static constexpr float period = 5.f;
+
+  // Vertices per ring of the tubes, 4 is a square
+  static constexpr int ringSizes[] = { 4, 6, 8, 12 };
+  static constexpr int defaultRingSize = 4;
+  static bool IsRingSize(int ringSize);
+
+  struct Counts
+  {
+    uint32_t vertexCount = 0;
+    uint32_t indexCount = 0;
+  };
+
+public:
+  // Upper bounds for a single curve
+  static Counts MaxCurveCounts(const Fractal::CreateInfo& createInfo, int ringSize = defaultRingSize);
+
+public:
+  FractalMesh() = delete;
+  explicit FractalMesh(const Fractal& fractal, int ringSize = defaultRingSize);
+
+  int ringSize() const { return ringSize_; }
+
+  // Upper bounds of a single Generate(), over all animation times
+  uint32_t MaxVertexCount() const { return maxCounts_.vertexCount; }
+  uint32_t MaxIndexCount() const { return maxCounts_.indexCount; }
+
+  // Not to be called from multiple threads at once, as calls share scratch memory
+  Counts Generate(float animationTime, float* vertices, uint32_t* indices) const;
+
+private:
+  const Fractal& fractal_;
+  int ringSize_ = defaultRingSize;
+  Counts maxCounts_;
+
+  // Ring scale of each step of the curve being generated, sized once so that Generate() doesn't allocate
+  mutable std::vector<float> ringScales_;
+};
+}
+}
+
+#endif // GLAR_SCENE_FRACTAL_MESH_H_
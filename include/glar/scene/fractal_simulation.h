@@ -0,0 +1,82 @@
+#ifndef GLAR_SCENE_FRACTAL_SIMULATION_H_
+#define GLAR_SCENE_FRACTAL_SIMULATION_H_
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <glar/scene/fractal_keyframes.h>
+#include <glar/scene/fractal_mesh.h>
+
+namespace glar
+{
+namespace scene
+{
+/**
+* Fractal mesh generated on a simulation thread, one animation step ahead of rendering
+*
+* The thread writes the mesh of the next step into the back frame while the render thread uploads the front frame, and
+* the frames swap when the back frame is complete. Animation time advances on a fixed step, so the mesh of a step is
+* generated once however often it is drawn.
+*
+* The thread is the only user of the keyframe cache while the simulation exists.
+*/
+class FractalSimulation
+{
+public:
+  struct CreateInfo
+  {
+    double timeStep = 1. / 60.; // Seconds, 0 for no simulation thread
+  };
+
+  struct Frame
+  {
+    int64_t step = -1;
+    FractalMesh::Counts counts;
+    std::vector<float> vertices;
+    std::vector<uint32_t> indices;
+
+    // Stats of the keyframe cache after generating the frame
+    FractalKeyframes::Stats keyframeStats;
+  };
+
+public:
+  FractalSimulation() = delete;
+  FractalSimulation(const FractalMesh& mesh, FractalKeyframes* keyframes, const CreateInfo& createInfo);
+  ~FractalSimulation();
+
+  FractalSimulation(const FractalSimulation&) = delete;
+  FractalSimulation& operator = (const FractalSimulation&) = delete;
+
+  const auto& info() const { return createInfo_; }
+
+  // Render thread. Requests the step after animationTime, and returns the newly completed frame, or nullptr if none
+  // completed since the last call. The frame stays valid until the next call.
+  const Frame* Update(double animationTime);
+
+private:
+  void Run();
+  void Generate(Frame& frame, int64_t step);
+
+  const FractalMesh& mesh_;
+  FractalKeyframes* keyframes_;
+  CreateInfo createInfo_;
+
+  Frame frames_[2];
+  int front_ = 0;
+  bool backReady_ = false;
+
+  int64_t targetStep_ = -1;
+  int64_t generatedStep_ = -1;
+  bool terminate_ = false;
+
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  std::thread thread_;
+};
+}
+}
+
+#endif // GLAR_SCENE_FRACTAL_SIMULATION_H_
@@ -0,0 +1,37 @@
+#ifndef GLAR_SCENE_RING_TRANSFORM_H_
+#define GLAR_SCENE_RING_TRANSFORM_H_
+
+#include <glm/glm.hpp>
+
+namespace glar
+{
+namespace scene
+{
+enum class RingTransformIsa
+{
+  SCALAR,
+  SSE,
+  AVX,
+};
+
+const char* ToString(RingTransformIsa isa);
+
+// Widest instruction set supported by both the build and the running CPU
+RingTransformIsa BestRingTransformIsa();
+
+/**
+* Transforms the ring of every step of a curve into interleaved vertices
+*
+* For each step i, writes ringSize vertices of base * stepTransforms[i] * (ring[j] * ringScales[i]), each followed by
+* color, 6 floats per vertex. Output is written sequentially, so it may point to a mapped GL buffer. Ring sizes of
+* FractalMesh::ringSizes run unrolled kernels.
+*/
+void TransformRings(const glm::mat4& base, const glm::mat4* stepTransforms, const float* ringScales, int stepCount,
+  const glm::vec3* ring, int ringSize, const glm::vec3& color, float* vertices);
+
+void TransformRings(const glm::mat4& base, const glm::mat4* stepTransforms, const float* ringScales, int stepCount,
+  const glm::vec3* ring, int ringSize, const glm::vec3& color, float* vertices, RingTransformIsa isa);
+}
+}
+
+#endif // GLAR_SCENE_RING_TRANSFORM_H_
@@ -0,0 +1,126 @@
+#ifndef GLAR_SENSOR_FRAME_SOURCE_H_
+#define GLAR_SENSOR_FRAME_SOURCE_H_
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include <opencv2/core.hpp>
+
+#include <glar/util/seqlock.h>
+
+namespace glar
+{
+namespace sensor
+{
+struct FrameSourceStats
+{
+  // Upper bounds of the jitter bins in seconds, the last bin is unbounded
+  static constexpr int jitterBinCount = 8;
+  static constexpr double jitterBinBounds[jitterBinCount - 1] = { 0.001, 0.002, 0.005, 0.01, 0.02, 0.05, 0.1 };
+
+  double targetFps = 0.;
+  double fps = 0.;
+
+  uint64_t frameCount = 0;
+  uint64_t reconnectCount = 0;
+
+  // Exponential moving averages in seconds
+  double averageInterval = 0.;
+  double averageReadTime = 0.;
+  double averageDecodeTime = 0.;
+
+  // Frame count by deviation of the frame interval from the average interval
+  uint64_t jitterHistogram[jitterBinCount] = {};
+
+  // Time since the last frame when the stats are taken, and the longest time without frames
+  double stallDuration = 0.;
+  double maxStallDuration = 0.;
+};
+
+/**
+* Camera stream read on a worker thread, keeping only the newest frame
+*
+* Stats are published by the worker and read without locks, so readers never hold up the worker.
+*/
+class FrameSource
+{
+public:
+  enum class Type
+  {
+    OPENCV,
+    MJPEG,
+  };
+
+  struct CreateInfo
+  {
+    Type type = Type::OPENCV;
+
+    // JPEG decode downscale of the MJPEG source, 1, 2, 4 or 8
+    int scaleDenominator = 1;
+
+    // MJPEG frames kept in planar YUV 4:2:0 from the decoder on, see util/i420.h
+    bool i420 = false;
+  };
+
+  static std::unique_ptr<FrameSource> Create(const std::string& address, const CreateInfo& createInfo);
+  static const char* ToString(Type type);
+
+public:
+  virtual ~FrameSource();
+
+  FrameSourceStats Stats() const;
+
+  // Takes the newest frame, empty if there is no new frame since the last call
+  cv::Mat Image();
+  cv::Mat Image(std::chrono::high_resolution_clock::time_point& captureTime);
+
+protected:
+  FrameSource();
+
+  // Accessed by worker
+  void Opened(double targetFps);
+  void UpdateTargetFps(double targetFps);
+  void UpdateImage(cv::Mat image, std::chrono::high_resolution_clock::time_point captureTime, double readTime, double decodeTime);
+
+  // Waits before the next open attempt, doubling the wait with every failure since the last frame.
+  // Returns false when terminated.
+  bool WaitReconnect();
+
+  // Wakes up waits of the worker, called before joining it
+  void Terminate();
+  bool Terminating() const { return terminate_; }
+
+private:
+  struct Snapshot
+  {
+    FrameSourceStats stats;
+    std::chrono::high_resolution_clock::time_point lastFrameTime;
+  };
+
+  void Publish();
+
+  // Written by workers under the mutex, and published to readers
+  Snapshot snapshot_;
+  bool receiving_ = false;
+  bool opened_ = false;
+  int failureCount_ = 0;
+  std::mutex statsMutex_;
+  util::SeqLock<Snapshot> publishedSnapshot_;
+
+  std::atomic_bool terminate_ = false;
+  std::mutex terminateMutex_;
+  std::condition_variable terminateCondition_;
+
+  cv::Mat image_;
+  std::chrono::high_resolution_clock::time_point captureTime_;
+  std::mutex mutex_;
+};
+}
+}
+
+#endif // GLAR_SENSOR_FRAME_SOURCE_H_
@@ -0,0 +1,46 @@
+#ifndef GLAR_SENSOR_JPEG_DECODER_H_
+#define GLAR_SENSOR_JPEG_DECODER_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include <opencv2/core.hpp>
+
+#include <glar/util/mat_pool.h>
+
+namespace glar
+{
+namespace sensor
+{
+/**
+* JPEG to BGR or planar YUV decoder on libjpeg-turbo, writing into pooled images
+*
+* Downscaling is done in the DCT domain, which skips most of the decoding work for the dropped resolution. YUV
+* decoding of 4:2:0 JPEGs skips the color conversion and chroma upsampling altogether.
+*/
+class JpegDecoder
+{
+public:
+  JpegDecoder();
+  ~JpegDecoder();
+
+  JpegDecoder(const JpegDecoder&) = delete;
+  JpegDecoder& operator = (const JpegDecoder&) = delete;
+
+  // Scale denominator 1, 2, 4 or 8. Returns an empty image on failure.
+  cv::Mat Decode(const uint8_t* data, size_t size, int scaleDenominator = 1);
+
+  // I420 frame, see util/i420.h. Other subsamplings are converted from BGR, and odd sized images stay BGR.
+  cv::Mat DecodeI420(const uint8_t* data, size_t size, int scaleDenominator = 1);
+
+  const util::MatPool::Stats& PoolStats() const { return pool_.stats(); }
+
+private:
+  void* handle_ = nullptr;
+
+  util::MatPool pool_;
+};
+}
+}
+
+#endif // GLAR_SENSOR_JPEG_DECODER_H_
@@ -0,0 +1,72 @@
+#ifndef GLAR_SENSOR_MJPEG_STREAM_H_
+#define GLAR_SENSOR_MJPEG_STREAM_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <glar/sensor/frame_source.h>
+#include <glar/sensor/jpeg_decoder.h>
+
+namespace glar
+{
+namespace util
+{
+class Socket;
+}
+
+namespace sensor
+{
+/**
+* MJPEG over HTTP client
+*
+* The receiver thread parses the multipart stream and keeps only the newest JPEG. The decoder thread decodes it, so
+* frames arriving faster than they are decoded are dropped before decoding, and nothing is buffered in between.
+*/
+class MjpegStream : public FrameSource
+{
+public:
+  MjpegStream() = delete;
+  // Address is http://host[:port][/path], the stream is read from path/video
+  MjpegStream(const std::string& address, int scaleDenominator = 1, bool i420 = false);
+  ~MjpegStream() override;
+
+private:
+  struct Frame
+  {
+    std::vector<uint8_t> data;
+    std::chrono::high_resolution_clock::time_point receiveTime;
+    double readTime = 0.;
+  };
+
+  void Receive();
+  void ReceiveStream(util::Socket& socket);
+  void Publish(Frame& frame);
+
+  void Decode();
+
+  std::string host_;
+  uint16_t port_ = 80;
+  std::string path_;
+  int scaleDenominator_;
+  bool i420_;
+
+  JpegDecoder decoder_;
+
+  // Newest received frame not taken by the decoder yet
+  Frame pending_;
+  bool hasPending_ = false;
+  std::mutex pendingMutex_;
+  std::condition_variable pendingCondition_;
+
+  std::thread receiveThread_;
+  std::thread decodeThread_;
+};
+}
+}
+
+#endif // GLAR_SENSOR_MJPEG_STREAM_H_
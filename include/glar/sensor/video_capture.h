@@ -3,10 +3,8 @@
 
 #include <string>
 #include <thread>
-#include <mutex>
-#include <atomic>
 
-#include <opencv2/opencv.hpp>
+#include <glar/sensor/frame_source.h>
 
 namespace glar
 {
@@ -14,35 +12,20 @@ namespace sensor
 {
 /**
 * Multithreaded video sensor wrapper
+*
+* The worker blocks on the stream until a frame arrives, and waits with exponential backoff to reopen a failed stream.
 */
-class VideoCapture
+class VideoCapture : public FrameSource
 {
 public:
   VideoCapture() = delete;
   explicit VideoCapture(const std::string& address);
-  ~VideoCapture();
-
-  double TargetFps() const;
-  double Fps() const;
-
-  cv::Mat Image();
-
-  // Accessed by worker
-  void UpdateImage(cv::Mat image);
+  ~VideoCapture() override;
 
 private:
   std::string videoStreamAddress_;
 
-  double fps_ = 0.;
-  double targetFps_ = 0.;
-  mutable std::mutex fpsMutex_;
-
   std::thread worker_;
-  std::atomic_bool terminate_ = false;
-
-  // TODO: Double buffering
-  cv::Mat image_;
-  std::mutex mutex_;
 };
 }
 }
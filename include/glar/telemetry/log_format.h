@@ -0,0 +1,106 @@
+#ifndef GLAR_TELEMETRY_LOG_FORMAT_H_
+#define GLAR_TELEMETRY_LOG_FORMAT_H_
+
+#include <cstdint>
+
+namespace glar
+{
+namespace telemetry
+{
+/**
+* Binary telemetry log written by glar
+*
+* [FileHeader][RecordHeader + record]...
+*
+* Records are length-prefixed, so readers skip types they don't know, and fields appended to a record type in a later
+* version are read as zero by older readers. All values are little-endian. Times are nanoseconds since the start of
+* the log, on the clock the app measures frames with.
+*/
+constexpr char logMagic[8] = { 'G', 'L', 'A', 'R', 'T', 'L', 'M', '\0' };
+constexpr uint32_t logVersion = 1;
+
+struct FileHeader
+{
+  char magic[8];
+  uint32_t version;
+  uint32_t headerSize;
+
+  // Start of the log in nanoseconds since the Unix epoch, for relating logs to each other
+  int64_t startTime;
+};
+
+enum class RecordType : uint16_t
+{
+  FRAME = 1,
+  DETECTION = 2,
+  POSE = 3,
+};
+
+struct RecordHeader
+{
+  RecordType type;
+  uint16_t size; // Bytes of the record following the header
+};
+
+// One iteration of the frame loop, durations of its stages
+struct FrameRecord
+{
+  static constexpr RecordType type = RecordType::FRAME;
+
+  uint64_t frame = 0;
+  int64_t startTime = 0;
+
+  int64_t uiTime = 0;
+  int64_t framesTime = 0;
+  int64_t resultsTime = 0;
+  int64_t renderTime = 0; // Including the buffer swap
+
+  uint32_t skipped = 0; // 1 if nothing was drawn
+  uint32_t streamCount = 0;
+};
+
+// Detection result of a camera frame, taken by the frame loop in frame
+struct DetectionRecord
+{
+  static constexpr RecordType type = RecordType::DETECTION;
+
+  uint64_t frame = 0;
+
+  int64_t captureTime = 0;
+  int64_t detectionStartTime = 0;
+  int64_t detectionEndTime = 0;
+  int64_t takeTime = 0;
+
+  uint32_t stream = 0;
+  uint32_t markerCount = 0;
+};
+
+// Marker pose of a detection result, following its DetectionRecord
+struct PoseRecord
+{
+  static constexpr RecordType type = RecordType::POSE;
+
+  uint64_t frame = 0;
+
+  uint32_t stream = 0;
+  int32_t markerId = 0;
+
+  // As in ipc::PoseRecord
+  double rvec[3] = {};
+  double tvec[3] = {};
+};
+
+inline const char* ToString(RecordType type)
+{
+  switch (type)
+  {
+  case RecordType::FRAME: return "frame";
+  case RecordType::DETECTION: return "detection";
+  case RecordType::POSE: return "pose";
+  default: return "unknown";
+  }
+}
+}
+}
+
+#endif // GLAR_TELEMETRY_LOG_FORMAT_H_
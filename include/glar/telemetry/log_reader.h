@@ -0,0 +1,51 @@
+#ifndef GLAR_TELEMETRY_LOG_READER_H_
+#define GLAR_TELEMETRY_LOG_READER_H_
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <glar/telemetry/log_format.h>
+
+namespace glar
+{
+namespace telemetry
+{
+/**
+* Sequential reader of a telemetry log
+*
+* A log cut off while writing is read up to its last complete record.
+*/
+class LogReader
+{
+public:
+  LogReader() = delete;
+
+  // Throws if the file is not a telemetry log
+  explicit LogReader(const std::string& filepath);
+
+  const FileHeader& header() const { return header_; }
+
+  // Next record of any type, false at the end of the log
+  bool Next(RecordHeader& header);
+
+  // Record read by the last Next(). Fields missing from a record of an older version keep their defaults.
+  template <typename Record>
+  Record As() const
+  {
+    Record record;
+    std::memcpy(&record, data_.data(), std::min(sizeof(Record), data_.size()));
+    return record;
+  }
+
+private:
+  std::ifstream in_;
+  FileHeader header_;
+  std::vector<char> data_;
+};
+}
+}
+
+#endif // GLAR_TELEMETRY_LOG_READER_H_
@@ -0,0 +1,123 @@
+#ifndef GLAR_TELEMETRY_LOG_WRITER_H_
+#define GLAR_TELEMETRY_LOG_WRITER_H_
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <glar/telemetry/log_format.h>
+#include <glar/util/spsc_queue.h>
+
+namespace glar
+{
+namespace telemetry
+{
+/**
+* Telemetry log written on a background thread
+*
+* Records are queued without locks or allocations and written to the file in batches, so logging costs the frame loop
+* a copy per record. A record that finds the queue full is dropped and counted instead of waiting.
+*/
+class LogWriter
+{
+public:
+  using Clock = std::chrono::high_resolution_clock;
+
+  struct CreateInfo
+  {
+    std::string filepath;
+    size_t queueCapacity = 16384; // Records
+    double flushInterval = 0.1; // Seconds
+  };
+
+  struct Stats
+  {
+    uint64_t queuedCount = 0;
+    uint64_t droppedCount = 0;
+    uint64_t writtenCount = 0;
+    uint64_t writtenBytes = 0;
+  };
+
+public:
+  LogWriter() = delete;
+  explicit LogWriter(const CreateInfo& createInfo);
+
+  // Writes the records queued so far
+  ~LogWriter();
+
+  LogWriter(const LogWriter&) = delete;
+  LogWriter& operator = (const LogWriter&) = delete;
+
+  const std::string& filepath() const { return createInfo_.filepath; }
+
+  // Nanoseconds since the start of the log
+  int64_t Timestamp(Clock::time_point time) const
+  {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time - startTime_).count();
+  }
+
+  // Called from a single thread. Returns false if the record is dropped.
+  template <typename Record>
+  bool Write(const Record& record)
+  {
+    static_assert(sizeof(Record) <= maxRecordSize, "Telemetry record too large");
+
+    QueuedRecord queued;
+    queued.header.type = Record::type;
+    queued.header.size = sizeof(Record);
+    std::memcpy(queued.data, &record, sizeof(Record));
+
+    if (!queue_.TryPush(queued))
+    {
+      droppedCount_++;
+      return false;
+    }
+
+    queuedCount_++;
+    return true;
+  }
+
+  // Called from the writing thread
+  Stats stats() const;
+
+private:
+  static constexpr size_t maxRecordSize = std::max({ sizeof(FrameRecord), sizeof(DetectionRecord), sizeof(PoseRecord) });
+
+  struct QueuedRecord
+  {
+    RecordHeader header;
+    alignas(8) char data[maxRecordSize];
+  };
+
+  void Run();
+
+  CreateInfo createInfo_;
+  Clock::time_point startTime_;
+
+  std::ofstream out_;
+
+  util::SpscQueue<QueuedRecord> queue_;
+
+  // Written by the producer only
+  uint64_t queuedCount_ = 0;
+  uint64_t droppedCount_ = 0;
+
+  std::atomic<uint64_t> writtenCount_ = 0;
+  std::atomic<uint64_t> writtenBytes_ = 0;
+
+  bool terminate_ = false;
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  std::thread thread_;
+};
+}
+}
+
+#endif // GLAR_TELEMETRY_LOG_WRITER_H_
@@ -0,0 +1,47 @@
+#ifndef GLAR_UTIL_ALLOCATION_COUNTER_H_
+#define GLAR_UTIL_ALLOCATION_COUNTER_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace glar
+{
+namespace util
+{
+struct AllocationCounts
+{
+  uint64_t count = 0;
+  uint64_t bytes = 0;
+};
+
+inline AllocationCounts operator - (const AllocationCounts& lhs, const AllocationCounts& rhs)
+{
+  return { lhs.count - rhs.count, lhs.bytes - rhs.bytes };
+}
+
+/**
+* Heap allocation counts for finding allocations in the frame loop
+*
+* Counts allocations through the global operator new, which is replaced for this, and buffers allocated by the pooled
+* Mat allocator. Allocations made inside DLLs with their own operator new are not seen. Costs a flag check per
+* allocation while disabled.
+*/
+class AllocationCounter
+{
+public:
+  static void SetEnabled(bool enabled);
+  static bool Enabled();
+
+  // Allocations of the calling thread while enabled, since the thread started
+  static AllocationCounts ThreadCounts();
+
+  // Allocations of all threads while enabled
+  static AllocationCounts TotalCounts();
+
+  // Counts an allocation made past operator new
+  static void Record(size_t bytes);
+};
+}
+}
+
+#endif // GLAR_UTIL_ALLOCATION_COUNTER_H_
@@ -0,0 +1,23 @@
+#ifndef GLAR_UTIL_I420_H_
+#define GLAR_UTIL_I420_H_
+
+#include <opencv2/core.hpp>
+
+namespace glar
+{
+namespace util
+{
+// Camera frames are either BGR images, or planar YUV 4:2:0 (I420) images in the OpenCV layout: a single-channel image
+// of 3/2 the frame height, holding the full size Y plane followed by the quarter size U and V planes.
+bool IsI420(const cv::Mat& frame);
+
+// Frame size in pixels, excluding the chroma rows of I420 frames
+cv::Size FrameSize(const cv::Mat& frame);
+
+// Grayscale Y plane of I420 frames, sharing the frame data, or BGR frames as they are. Detection runs on this image,
+// and overlays drawn into it end up in the frame.
+cv::Mat DetectionImage(const cv::Mat& frame);
+}
+}
+
+#endif // GLAR_UTIL_I420_H_
@@ -0,0 +1,41 @@
+#ifndef GLAR_UTIL_MAPPED_FILE_H_
+#define GLAR_UTIL_MAPPED_FILE_H_
+
+#include <cstddef>
+#include <string>
+
+namespace glar
+{
+namespace util
+{
+/**
+* Read-only memory mapping of a whole file
+*/
+class MappedFile
+{
+public:
+  MappedFile() = delete;
+  explicit MappedFile(const std::string& filepath);
+  ~MappedFile();
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator = (const MappedFile&) = delete;
+
+  const void* Data() const { return data_; }
+  size_t Size() const { return size_; }
+
+private:
+#ifdef _WIN32
+  void* file_ = nullptr;
+  void* mapping_ = nullptr;
+#else
+  int file_ = -1;
+#endif
+
+  void* data_ = nullptr;
+  size_t size_ = 0;
+};
+}
+}
+
+#endif // GLAR_UTIL_MAPPED_FILE_H_
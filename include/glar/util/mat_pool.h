@@ -0,0 +1,47 @@
+#ifndef GLAR_UTIL_MAT_POOL_H_
+#define GLAR_UTIL_MAT_POOL_H_
+
+#include <cstdint>
+#include <vector>
+
+#include <opencv2/core.hpp>
+
+namespace glar
+{
+namespace util
+{
+/**
+* Reuses images once they are no longer referenced outside of the pool
+*
+* Not thread-safe. Images handed out may be used and released on any thread.
+*/
+class MatPool
+{
+public:
+  struct Stats
+  {
+    uint64_t allocationCount = 0;
+    uint64_t reuseCount = 0;
+  };
+
+public:
+  MatPool() = delete;
+  explicit MatPool(int capacity);
+  ~MatPool();
+
+  cv::Mat Acquire(int rows, int cols, int type);
+
+  const Stats& stats() const { return stats_; }
+
+private:
+  static bool Free(const cv::Mat& image);
+
+  int capacity_;
+  std::vector<cv::Mat> images_;
+
+  Stats stats_;
+};
+}
+}
+
+#endif // GLAR_UTIL_MAT_POOL_H_
@@ -0,0 +1,71 @@
+#ifndef GLAR_UTIL_PHILOX_H_
+#define GLAR_UTIL_PHILOX_H_
+
+#include <array>
+#include <cstdint>
+
+namespace glar
+{
+namespace util
+{
+/**
+* Philox4x32-10 counter-based random number generator (Salmon et al., "Parallel random numbers: as easy as 1, 2, 3")
+*
+* Random values are a pure function of a key and a counter, so any value of a stream can be computed on any thread
+* without generating the ones before it.
+*/
+class Philox
+{
+public:
+  using Counter = std::array<uint32_t, 4>;
+  using Key = std::array<uint32_t, 2>;
+
+public:
+  Philox() = delete;
+  explicit Philox(Key key) : key_(key) {}
+
+  // Four independent random words of a counter
+  Counter operator () (Counter counter) const
+  {
+    auto key = key_;
+    for (int i = 0; i < roundCount; i++)
+    {
+      counter = Round(counter, key);
+      key[0] += weyl0;
+      key[1] += weyl1;
+    }
+    return counter;
+  }
+
+  // Uniform in [0, 1), from the upper 24 bits so that every value is exactly representable
+  static float ToFloat(uint32_t word)
+  {
+    return static_cast<float>(word >> 8) * (1.f / 16777216.f);
+  }
+
+private:
+  static constexpr int roundCount = 10;
+  static constexpr uint32_t multiplier0 = 0xD2511F53;
+  static constexpr uint32_t multiplier1 = 0xCD9E8D57;
+  static constexpr uint32_t weyl0 = 0x9E3779B9;
+  static constexpr uint32_t weyl1 = 0xBB67AE85;
+
+  static Counter Round(const Counter& counter, const Key& key)
+  {
+    const auto product0 = static_cast<uint64_t>(multiplier0) * counter[0];
+    const auto product1 = static_cast<uint64_t>(multiplier1) * counter[2];
+
+    const auto hi0 = static_cast<uint32_t>(product0 >> 32);
+    const auto lo0 = static_cast<uint32_t>(product0);
+    const auto hi1 = static_cast<uint32_t>(product1 >> 32);
+    const auto lo1 = static_cast<uint32_t>(product1);
+
+    return { hi1 ^ counter[1] ^ key[0], lo1, hi0 ^ counter[3] ^ key[1], lo0 };
+  }
+
+  Key key_;
+};
+}
+}
+
+#endif // GLAR_UTIL_PHILOX_H_
@@ -0,0 +1,65 @@
+#ifndef GLAR_UTIL_POOLED_MAT_ALLOCATOR_H_
+#define GLAR_UTIL_POOLED_MAT_ALLOCATOR_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <vector>
+
+#include <opencv2/core.hpp>
+
+namespace glar
+{
+namespace util
+{
+/**
+* Mat allocator keeping freed frame-sized buffers for reuse
+*
+* Camera frames and the detector's per-frame images are allocated and freed at the same few sizes every frame, so
+* after the first frames they are served from the pool. Small buffers go to the heap as usual. Thread-safe.
+*/
+class PooledMatAllocator : public cv::MatAllocator
+{
+public:
+  struct Stats
+  {
+    uint64_t allocationCount = 0;
+    uint64_t reuseCount = 0;
+    size_t pooledBytes = 0;
+  };
+
+public:
+  PooledMatAllocator() = delete;
+  // Buffers of at least minPooledSize bytes are pooled, up to maxPooledBytes of free buffers
+  PooledMatAllocator(size_t minPooledSize, size_t maxPooledBytes);
+  ~PooledMatAllocator() override;
+
+  // Installs a pool as the default allocator of all Mats. It is never destroyed, as Mats may be freed at any time
+  // until exit.
+  static PooledMatAllocator& InstallDefault();
+
+  Stats stats() const;
+
+  cv::UMatData* allocate(int dims, const int* sizes, int type, void* data, size_t* step,
+    cv::AccessFlag flags, cv::UMatUsageFlags usageFlags) const override;
+  bool allocate(cv::UMatData* data, cv::AccessFlag accessFlags, cv::UMatUsageFlags usageFlags) const override;
+  void deallocate(cv::UMatData* data) const override;
+
+private:
+  void* AllocateBuffer(size_t size) const;
+  void FreeBuffer(void* buffer, size_t size) const;
+
+  size_t minPooledSize_;
+  size_t maxPooledBytes_;
+
+  // Free buffers by size, and free records for UMatData
+  mutable std::map<size_t, std::vector<void*>> buffers_;
+  mutable std::vector<void*> records_;
+  mutable Stats stats_;
+  mutable std::mutex mutex_;
+};
+}
+}
+
+#endif // GLAR_UTIL_POOLED_MAT_ALLOCATOR_H_
@@ -0,0 +1,88 @@
+#ifndef GLAR_UTIL_SEQLOCK_H_
+#define GLAR_UTIL_SEQLOCK_H_
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <type_traits>
+
+namespace glar
+{
+namespace util
+{
+/**
+* Value published by one writer at a time and read without locks
+*
+* Readers retry while a store is in progress, so they never block the writer. The value is kept in atomic words, so
+* a torn read is detected by the sequence number instead of being a data race.
+*/
+template <typename T>
+class SeqLock
+{
+  static_assert(std::is_trivially_copyable<T>::value, "SeqLock value must be trivially copyable");
+
+private:
+  static constexpr size_t wordCount = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+public:
+  SeqLock()
+  {
+    Store(T{});
+  }
+
+  explicit SeqLock(const T& value)
+  {
+    Store(value);
+  }
+
+  // Writers must be serialized by the caller
+  void Store(const T& value)
+  {
+    uint64_t words[wordCount] = {};
+    std::memcpy(words, &value, sizeof(T));
+
+    // Odd sequence while writing
+    const auto sequence = sequence_.load(std::memory_order_relaxed);
+    sequence_.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    for (size_t i = 0; i < wordCount; i++)
+      words_[i].store(words[i], std::memory_order_relaxed);
+
+    sequence_.store(sequence + 2, std::memory_order_release);
+  }
+
+  T Load() const
+  {
+    uint64_t words[wordCount];
+    while (true)
+    {
+      const auto sequence = sequence_.load(std::memory_order_acquire);
+      if (sequence & 1)
+      {
+        std::this_thread::yield();
+        continue;
+      }
+
+      for (size_t i = 0; i < wordCount; i++)
+        words[i] = words_[i].load(std::memory_order_relaxed);
+
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (sequence_.load(std::memory_order_relaxed) == sequence)
+        break;
+    }
+
+    T value;
+    std::memcpy(&value, words, sizeof(T));
+    return value;
+  }
+
+private:
+  std::atomic<uint64_t> sequence_ = 0;
+  std::atomic<uint64_t> words_[wordCount];
+};
+}
+}
+
+#endif // GLAR_UTIL_SEQLOCK_H_
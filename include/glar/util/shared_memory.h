@@ -0,0 +1,52 @@
+#ifndef GLAR_UTIL_SHARED_MEMORY_H_
+#define GLAR_UTIL_SHARED_MEMORY_H_
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+namespace glar
+{
+namespace util
+{
+/**
+* Named memory region shared between processes of the same machine
+*
+* POSIX shared memory object, or a named file mapping backed by the paging file on Windows. The creator removes the
+* name on destruction, processes that opened it keep their mapping until they close it.
+*/
+class SharedMemory
+{
+public:
+  SharedMemory() = delete;
+  ~SharedMemory();
+
+  SharedMemory(const SharedMemory&) = delete;
+  SharedMemory& operator = (const SharedMemory&) = delete;
+
+  // Replaces a region left over with the same name. Contents are zero-initialized.
+  static std::unique_ptr<SharedMemory> Create(const std::string& name, size_t size);
+  static std::unique_ptr<SharedMemory> Open(const std::string& name);
+
+  void* Data() const { return data_; }
+  size_t Size() const { return size_; }
+
+private:
+  SharedMemory(const std::string& name, size_t size, bool create);
+
+  std::string name_;
+  bool created_ = false;
+
+#ifdef _WIN32
+  void* mapping_ = nullptr;
+#else
+  int file_ = -1;
+#endif
+
+  void* data_ = nullptr;
+  size_t size_ = 0;
+};
+}
+}
+
+#endif // GLAR_UTIL_SHARED_MEMORY_H_
@@ -0,0 +1,56 @@
+#ifndef GLAR_UTIL_SOCKET_H_
+#define GLAR_UTIL_SOCKET_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace glar
+{
+namespace util
+{
+/**
+* Blocking TCP socket
+*/
+class Socket
+{
+public:
+  Socket() = delete;
+  ~Socket();
+
+  Socket(const Socket&) = delete;
+  Socket& operator = (const Socket&) = delete;
+
+  // Throw on failure
+  static std::unique_ptr<Socket> Connect(const std::string& host, uint16_t port);
+  static std::unique_ptr<Socket> Listen(uint16_t port);
+
+  // Nullptr on failure
+  std::unique_ptr<Socket> Accept();
+
+  // Applies to both receive and send
+  void SetTimeout(double seconds);
+
+  // Returns 0 when the connection is closed, on error or on timeout
+  size_t Receive(void* data, size_t size);
+
+  // Sends everything, false on failure
+  bool Send(const void* data, size_t size);
+  bool Send(const std::string& data);
+
+private:
+#ifdef _WIN32
+  using Handle = uintptr_t;
+#else
+  using Handle = int;
+#endif
+
+  explicit Socket(Handle handle);
+
+  Handle handle_;
+};
+}
+}
+
+#endif // GLAR_UTIL_SOCKET_H_
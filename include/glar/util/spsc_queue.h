@@ -0,0 +1,90 @@
+#ifndef GLAR_UTIL_SPSC_QUEUE_H_
+#define GLAR_UTIL_SPSC_QUEUE_H_
+
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+namespace glar
+{
+namespace util
+{
+/**
+* Bounded lock-free queue of one producer thread and one consumer thread
+*
+* Neither side ever blocks: a push to a full queue and a pop from an empty queue fail. Each side keeps a copy of the
+* other side's index, so the shared indices are only read when the copy runs out.
+*/
+template <typename T>
+class SpscQueue
+{
+  static_assert(std::is_trivially_copyable<T>::value, "SpscQueue value must be trivially copyable");
+
+public:
+  SpscQueue() = delete;
+
+  // Rounded up to a power of two
+  explicit SpscQueue(size_t capacity)
+  {
+    size_t size = 1;
+    while (size < capacity)
+      size *= 2;
+
+    slots_.resize(size);
+    mask_ = size - 1;
+  }
+
+  SpscQueue(const SpscQueue&) = delete;
+  SpscQueue& operator = (const SpscQueue&) = delete;
+
+  size_t capacity() const { return slots_.size(); }
+
+  // Producer
+  bool TryPush(const T& value)
+  {
+    const auto tail = tail_.load(std::memory_order_relaxed);
+    if (tail - producerHead_ == slots_.size())
+    {
+      producerHead_ = head_.load(std::memory_order_acquire);
+      if (tail - producerHead_ == slots_.size())
+        return false;
+    }
+
+    slots_[tail & mask_] = value;
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Consumer
+  bool TryPop(T& value)
+  {
+    const auto head = head_.load(std::memory_order_relaxed);
+    if (head == consumerTail_)
+    {
+      consumerTail_ = tail_.load(std::memory_order_acquire);
+      if (head == consumerTail_)
+        return false;
+    }
+
+    value = slots_[head & mask_];
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+private:
+  std::vector<T> slots_;
+  size_t mask_ = 0;
+
+  // Indices grow without wrapping, slots are indexed modulo capacity. Separate cache lines keep the two sides from
+  // invalidating each other's line on every operation.
+  alignas(64) std::atomic<size_t> head_ = 0;
+  size_t consumerTail_ = 0;
+
+  alignas(64) std::atomic<size_t> tail_ = 0;
+  size_t producerHead_ = 0;
+};
+}
+}
+
+#endif // GLAR_UTIL_SPSC_QUEUE_H_
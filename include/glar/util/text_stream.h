@@ -0,0 +1,53 @@
+#ifndef GLAR_UTIL_TEXT_STREAM_H_
+#define GLAR_UTIL_TEXT_STREAM_H_
+
+#include <ostream>
+#include <streambuf>
+#include <vector>
+
+namespace glar
+{
+namespace util
+{
+/**
+* Output stream into a buffer kept between uses
+*
+* Text rebuilt every frame allocates only until the buffer has grown to the longest text.
+*/
+class TextStream : public std::ostream
+{
+public:
+  TextStream();
+  ~TextStream() override;
+
+  TextStream(const TextStream&) = delete;
+  TextStream& operator = (const TextStream&) = delete;
+
+  // Empties the text, keeping the buffer
+  void Clear();
+
+  // Null-terminated text written since the last Clear()
+  const char* c_str();
+
+private:
+  class Buffer : public std::streambuf
+  {
+  public:
+    Buffer();
+
+    void Clear();
+    const char* c_str();
+
+  protected:
+    int_type overflow(int_type c) override;
+
+  private:
+    std::vector<char> data_;
+  };
+
+  Buffer buffer_;
+};
+}
+}
+
+#endif // GLAR_UTIL_TEXT_STREAM_H_
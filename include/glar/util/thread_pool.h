@@ -0,0 +1,48 @@
+#ifndef GLAR_UTIL_THREAD_POOL_H_
+#define GLAR_UTIL_THREAD_POOL_H_
+
+#include <vector>
+#include <deque>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace glar
+{
+namespace util
+{
+/**
+* Fixed-size worker pool executing tasks in FIFO order
+*/
+class ThreadPool
+{
+public:
+  ThreadPool() = delete;
+  explicit ThreadPool(int workerCount);
+  ~ThreadPool();
+
+  int WorkerCount() const { return static_cast<int>(workers_.size()); }
+
+  void Enqueue(std::function<void()> task);
+
+  // Blocks until all enqueued tasks are finished
+  void Wait();
+
+private:
+  void Work();
+
+  std::vector<std::thread> workers_;
+
+  std::deque<std::function<void()>> tasks_;
+  int runningTaskCount_ = 0;
+  bool terminate_ = false;
+
+  std::mutex mutex_;
+  std::condition_variable taskCondition_;
+  std::condition_variable idleCondition_;
+};
+}
+}
+
+#endif // GLAR_UTIL_THREAD_POOL_H_
@@ -0,0 +1,145 @@
+#ifndef GLAR_VISION_DETECTION_SCHEDULER_H_
+#define GLAR_VISION_DETECTION_SCHEDULER_H_
+
+#include <cstdint>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+
+#include <opencv2/core.hpp>
+
+#include <glar/util/allocation_counter.h>
+#include <glar/util/thread_pool.h>
+#include <glar/vision/marker_detector.h>
+#include <glar/vision/marker_tracker.h>
+#include <glar/vision/pose_solver.h>
+
+namespace glar
+{
+namespace vision
+{
+/**
+* Schedules marker detection of multiple camera streams on a shared, fixed-size worker pool
+*
+* Each stream keeps at most one pending frame; a newer frame replaces the pending one, so the detection load is bounded
+* by the pool size rather than by the number of cameras. Pending streams are served in round-robin order.
+*/
+class DetectionScheduler
+{
+public:
+  using Clock = std::chrono::high_resolution_clock;
+
+  struct Result
+  {
+    cv::Mat image;
+    MarkerDetection detection;
+    Clock::time_point captureTime;
+
+    // Detection on the worker, excluding the wait for a worker
+    Clock::time_point detectionStartTime;
+    Clock::time_point detectionEndTime;
+  };
+
+  struct StreamStats
+  {
+    uint64_t submittedFrames = 0;
+    uint64_t processedFrames = 0;
+    uint64_t droppedFrames = 0;
+
+    // Capture to detection result, in seconds
+    double averageLatency = 0.;
+    double maxLatency = 0.;
+    double averageDetectionTime = 0.;
+
+    // Fraction of all processed frames
+    double share = 0.;
+  };
+
+public:
+  DetectionScheduler() = delete;
+  DetectionScheduler(MarkerDetector& detector, int workerCount);
+  ~DetectionScheduler();
+
+  int WorkerCount() const { return pool_.WorkerCount(); }
+
+  int AddStream();
+  void RemoveStream(int stream);
+
+  void Submit(int stream, cv::Mat image, Clock::time_point captureTime);
+
+  // Returns true if a result newer than the last taken one is available. The previous contents of result are kept
+  // for reuse by a later detection of the stream, so pass the same result every time.
+  bool TakeResult(int stream, Result& result);
+
+  StreamStats Stats(int stream) const;
+  PoseSolverStats PoseStats(int stream) const;
+  MarkerTrackerStats TrackerStats(int stream) const;
+
+  // Jain's fairness index of processed frames over streams, 1 when all streams are served equally
+  double FairnessIndex() const;
+
+  // Heap allocations of all detections while allocation counting is enabled
+  util::AllocationCounts Allocations() const;
+
+  // Waits for running detections, so that the detector is not read while updating
+  void SetCameraParameters(cv::Mat cameraMatrix, cv::Mat distortion);
+
+  // Replaces pose solvers of all streams, running detections finish with the previous ones
+  void SetPoseSolver(PoseSolver::Type type);
+  PoseSolver::Type PoseSolverType() const;
+
+  // Optical flow tracking between full detections, restarts tracking of all streams
+  void SetTracking(bool enabled, const MarkerTracker::CreateInfo& createInfo);
+
+private:
+  struct Stream
+  {
+    bool busy = false;
+    bool hasPending = false;
+    cv::Mat pendingImage;
+    Clock::time_point pendingCaptureTime;
+
+    bool hasResult = false;
+    Result result;
+
+    // Buffers of a taken or dropped result, written by the next detection
+    Result spareResult;
+
+    StreamStats stats;
+
+    // Shared with a running detection
+    std::shared_ptr<PoseSolver> poseSolver;
+    std::shared_ptr<MarkerTracker> tracker;
+  };
+
+  // Called with mutex_ locked
+  void Dispatch();
+  void Detect(int stream, cv::Mat image, Clock::time_point captureTime,
+    std::shared_ptr<PoseSolver> poseSolver, std::shared_ptr<MarkerTracker> tracker);
+
+  MarkerDetector& detector_;
+
+  std::map<int, Stream> streams_;
+  int nextStreamId_ = 0;
+  int nextDispatchStream_ = 0;
+
+  PoseSolver::Type poseSolverType_ = PoseSolver::Type::ITERATIVE;
+
+  bool tracking_ = false;
+  MarkerTracker::CreateInfo trackerCreateInfo_;
+
+  util::AllocationCounts allocations_;
+
+  int runningCount_ = 0;
+  bool paused_ = false;
+  mutable std::mutex mutex_;
+  std::condition_variable idleCondition_;
+
+  util::ThreadPool pool_;
+};
+}
+}
+
+#endif // GLAR_VISION_DETECTION_SCHEDULER_H_
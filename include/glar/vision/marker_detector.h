@@ -0,0 +1,77 @@
+#ifndef GLAR_VISION_MARKER_DETECTOR_H_
+#define GLAR_VISION_MARKER_DETECTOR_H_
+
+#include <string>
+#include <vector>
+
+#include <opencv2/core.hpp>
+#include <opencv2/aruco.hpp>
+
+#include <glm/glm.hpp>
+
+#include <glar/vision/pose_solver.h>
+
+namespace glar
+{
+namespace vision
+{
+struct MarkerDetection
+{
+  std::vector<int> ids;
+  std::vector<std::vector<cv::Point2f>> corners;
+  std::vector<std::vector<cv::Point2f>> rejected;
+
+  // Empty if pose is not estimated
+  std::vector<cv::Vec3d> rvecs;
+  std::vector<cv::Vec3d> tvecs;
+
+  void Clear();
+};
+
+/**
+* ArUco marker detection and pose estimation
+*
+* Detect() only reads the detector state, so it can be called from multiple worker threads at once.
+*/
+class MarkerDetector
+{
+public:
+  MarkerDetector() = delete;
+  explicit MarkerDetector(float markerSize);
+  ~MarkerDetector();
+
+  float MarkerSize() const { return markerSize_; }
+  const auto& Dictionary() const { return dictionary_; }
+  const auto& Parameters() const { return parameters_; }
+  const auto& CameraMatrix() const { return cameraMatrix_; }
+  const auto& Distortion() const { return distortion_; }
+
+  // Not thread-safe against running Detect()
+  void SetCameraParameters(cv::Mat cameraMatrix, cv::Mat distortion);
+
+  // Detector parameters profile, such as the output of glar_tools autotune. Not thread-safe against running Detect().
+  bool LoadParameters(const std::string& filepath);
+
+  void Detect(const cv::Mat& image, MarkerDetection& detection, bool estimatePose = true) const;
+
+  // Estimates pose with the solver, which belongs to the caller's camera stream
+  void Detect(const cv::Mat& image, MarkerDetection& detection, PoseSolver& poseSolver) const;
+  void DrawDetection(cv::Mat& image, const MarkerDetection& detection) const;
+
+  // Marker space to camera space, scaled so that the marker spans [-1, 1]
+  glm::mat4 ModelMatrix(const cv::Vec3d& rvec, const cv::Vec3d& tvec) const;
+  glm::mat3 Intrinsic() const;
+
+private:
+  float markerSize_ = 0.f;
+
+  cv::Ptr<cv::aruco::Dictionary> dictionary_;
+  cv::Ptr<cv::aruco::DetectorParameters> parameters_;
+
+  cv::Mat cameraMatrix_;
+  cv::Mat distortion_;
+};
+}
+}
+
+#endif // GLAR_VISION_MARKER_DETECTOR_H_
@@ -0,0 +1,86 @@
+#ifndef GLAR_VISION_MARKER_TRACKER_H_
+#define GLAR_VISION_MARKER_TRACKER_H_
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include <opencv2/core.hpp>
+
+#include <glar/vision/marker_detector.h>
+#include <glar/vision/pose_solver.h>
+
+namespace glar
+{
+namespace vision
+{
+struct MarkerTrackerStats
+{
+  uint64_t frameCount = 0;
+  uint64_t detectionCount = 0; // Frames with full detection
+  uint64_t lostCount = 0;      // Tracking failures that fell back to full detection
+
+  // Seconds, moving averages
+  double averageDetectionTime = 0.;
+  double averageTrackingTime = 0.;
+};
+
+/**
+* Marker detection with optical flow tracking in between
+*
+* Full detection runs every few frames, or when a marker is lost. In between, marker corners are propagated with
+* pyramidal Lucas-Kanade optical flow, and a marker is lost when any corner fails the forward-backward check. Pose is
+* estimated every frame. Keeps the previous frame, so use one tracker per camera stream, one frame at a time.
+*/
+class MarkerTracker
+{
+public:
+  struct CreateInfo
+  {
+    int detectionInterval = 10;
+    int pyramidLevels = 3;
+    int windowSize = 21;
+    float maxForwardBackwardError = 1.f; // In pixels
+  };
+
+public:
+  MarkerTracker() = delete;
+  MarkerTracker(const MarkerDetector& detector, const CreateInfo& createInfo);
+  ~MarkerTracker();
+
+  const auto& info() const { return createInfo_; }
+  MarkerTrackerStats Stats() const;
+
+  // Returns true if the frame ran full detection
+  bool Track(const cv::Mat& image, MarkerDetection& detection, PoseSolver& poseSolver);
+
+private:
+  // Returns false if any marker is lost
+  bool TrackCorners(MarkerDetection& detection);
+
+  const MarkerDetector& detector_;
+  CreateInfo createInfo_;
+
+  int framesSinceDetection_ = 0;
+
+  std::vector<int> ids_;
+  std::vector<std::vector<cv::Point2f>> corners_;
+  std::vector<cv::Mat> previousPyramid_;
+
+  // Per-frame intermediates
+  cv::Mat gray_;
+  std::vector<cv::Mat> pyramid_;
+  std::vector<cv::Point2f> points_;
+  std::vector<cv::Point2f> forwardPoints_;
+  std::vector<cv::Point2f> backwardPoints_;
+  std::vector<uint8_t> forwardStatus_;
+  std::vector<uint8_t> backwardStatus_;
+  std::vector<float> errors_;
+
+  mutable std::mutex statsMutex_;
+  MarkerTrackerStats stats_;
+};
+}
+}
+
+#endif // GLAR_VISION_MARKER_TRACKER_H_
@@ -0,0 +1,89 @@
+#ifndef GLAR_VISION_POSE_SOLVER_H_
+#define GLAR_VISION_POSE_SOLVER_H_
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <opencv2/core.hpp>
+
+namespace glar
+{
+namespace vision
+{
+struct PoseSolverStats
+{
+  uint64_t frameCount = 0;
+  uint64_t markerCount = 0;
+
+  // Wall time per marker in seconds and RMS reprojection error in pixels, moving averages
+  double averageSolveTime = 0.;
+  double averageReprojectionError = 0.;
+  double maxReprojectionError = 0.;
+};
+
+/**
+* Marker pose estimation from detected corners
+*
+* Markers of a frame are solved in parallel when there are many of them. Solvers may keep state between frames, so use
+* one solver per camera stream, one frame at a time. Stats can be read from any thread.
+*/
+class PoseSolver
+{
+public:
+  enum class Type
+  {
+    ITERATIVE,   // Generic iterative PnP from scratch, as cv::aruco::estimatePoseSingleMarkers
+    IPPE_SQUARE, // Analytic solution for square markers
+    TRACKING,    // Iterative refinement from the previous pose of the same marker
+  };
+
+  static const char* ToString(Type type);
+  static std::unique_ptr<PoseSolver> Create(Type type, float markerSize);
+
+public:
+  PoseSolver() = delete;
+  explicit PoseSolver(float markerSize);
+  virtual ~PoseSolver();
+
+  float MarkerSize() const { return markerSize_; }
+
+  PoseSolverStats Stats() const;
+
+  void Solve(const std::vector<int>& ids, const std::vector<std::vector<cv::Point2f>>& corners,
+    const cv::Mat& cameraMatrix, const cv::Mat& distortion,
+    std::vector<cv::Vec3d>& rvecs, std::vector<cv::Vec3d>& tvecs);
+
+protected:
+  // Marker corners in marker space, in the order of detected corners
+  const std::vector<cv::Point3f>& ObjectPoints() const { return objectPoints_; }
+
+  double ReprojectionError(const std::vector<cv::Point2f>& corners, const cv::Mat& cameraMatrix, const cv::Mat& distortion,
+    const cv::Vec3d& rvec, const cv::Vec3d& tvec) const;
+
+  // Previous pose of the marker, called before solving the frame
+  virtual bool Guess(int id, cv::Vec3d& rvec, cv::Vec3d& tvec) { return false; }
+
+  // Called concurrently for markers of a frame. Returns the reprojection error.
+  virtual double SolveMarker(const std::vector<cv::Point2f>& corners, const cv::Mat& cameraMatrix, const cv::Mat& distortion,
+    bool useGuess, cv::Vec3d& rvec, cv::Vec3d& tvec) const = 0;
+
+  // Called after solving the frame
+  virtual void Update(const std::vector<int>& ids, const std::vector<cv::Vec3d>& rvecs, const std::vector<cv::Vec3d>& tvecs) {}
+
+private:
+  float markerSize_ = 0.f;
+  std::vector<cv::Point3f> objectPoints_;
+
+  // Per-frame intermediates
+  std::vector<uint8_t> useGuess_;
+  std::vector<double> errors_;
+
+  mutable std::mutex statsMutex_;
+  PoseSolverStats stats_;
+};
+}
+}
+
+#endif // GLAR_VISION_POSE_SOLVER_H_
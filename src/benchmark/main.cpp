@@ -0,0 +1,425 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <glm/gtx/transform.hpp>
+#include <glm/gtx/quaternion.hpp>
+
+#include <glar/scene/fractal.h>
+#include <glar/scene/fractal_mesh.h>
+#include <glar/scene/ring_transform.h>
+
+namespace
+{
+using Clock = std::chrono::high_resolution_clock;
+
+constexpr int ringSize = 4;
+constexpr float radius = 0.5f;
+const glm::vec3 ring[ringSize] = {
+  glm::vec3(-1.f, -1.f, 0.f) * radius,
+  glm::vec3(1.f, -1.f, 0.f) * radius,
+  glm::vec3(1.f, 1.f, 0.f) * radius,
+  glm::vec3(-1.f, 1.f, 0.f) * radius,
+};
+const glm::vec3 color = glm::vec3(0.25f, 0.25f, 0.25f);
+
+// Curve counts of the fractal creation and mesh sweeps
+constexpr uint32_t sweepCurveCounts[] = { 100, 1000, 10000, 100000, 1000000 };
+
+// Animation times of the mesh sweep: early growth, half grown and fully grown
+constexpr float sweepAnimationTimes[] = { 0.5f, 1.25f, 2.5f };
+
+struct Result
+{
+  std::string name;
+  double seconds = 0.;
+
+  // Vertices or curves processed per call
+  uint64_t itemCount = 0;
+};
+
+/**
+* Discards std::cout output while alive, for code under measurement that logs
+*/
+class MutedOutput
+{
+public:
+  MutedOutput()
+    : buffer_(std::cout.rdbuf(nullptr))
+  {
+  }
+
+  ~MutedOutput()
+  {
+    std::cout.rdbuf(buffer_);
+    std::cout.clear();
+  }
+
+private:
+  std::streambuf* buffer_;
+};
+
+// Seconds per call, best of a few repeats
+double Measure(int iterations, const std::function<void()>& f)
+{
+  double best = 0.;
+  for (int repeat = 0; repeat < 5; repeat++)
+  {
+    const auto start = Clock::now();
+    for (int i = 0; i < iterations; i++)
+      f();
+    const auto seconds = std::chrono::duration<double>(Clock::now() - start).count() / iterations;
+
+    if (repeat == 0 || seconds < best)
+      best = seconds;
+  }
+  return best;
+}
+
+// Per-step transform composition as done before step tables
+void RebuildRings(const glar::scene::Fractal& fractal, float* vertices)
+{
+  const auto& info = fractal.info();
+
+  for (const auto& curve : fractal.curves())
+  {
+    glm::mat4 transform = glm::mat4(1.f);
+    for (int i = 0; i <= info.steps; i++)
+    {
+      for (const auto& ringVertex : ring)
+      {
+        const auto v = curve.base * transform * glm::vec4(ringVertex, 1.f);
+        vertices[0] = v.x;
+        vertices[1] = v.y;
+        vertices[2] = v.z;
+        vertices[3] = color.r;
+        vertices[4] = color.g;
+        vertices[5] = color.b;
+        vertices += 6;
+      }
+
+      if (i < info.steps)
+      {
+        transform =
+          glm::translate(glm::vec3(0.f, 0.f, info.height / info.steps))
+          * glm::toMat4(glm::angleAxis(info.curveAngle / info.steps, glm::vec3(1.f, 0.f, 0.f)))
+          * glm::scale(glm::vec3(std::exp(-info.scaleCoeff)))
+          * transform;
+      }
+    }
+  }
+}
+
+void TableRings(const glar::scene::Fractal& fractal, const float* ringScales, float* vertices, glar::scene::RingTransformIsa isa)
+{
+  const auto stepCount = fractal.info().steps + 1;
+  const auto stepTransforms = fractal.stepTransforms().data();
+
+  for (const auto& curve : fractal.curves())
+  {
+    glar::scene::TransformRings(curve.base, stepTransforms, ringScales, stepCount, ring, ringSize, color, vertices, isa);
+    vertices += 6 * ringSize * stepCount;
+  }
+}
+
+double Checksum(const std::vector<float>& values)
+{
+  double sum = 0.;
+  for (auto value : values)
+    sum += value;
+  return sum;
+}
+
+void PrintRow(const std::string& name, double seconds, double baseline, size_t vertexCount, double checksum)
+{
+  std::cout << std::left << std::setw(20) << name << std::right
+    << std::setw(12) << std::fixed << std::setprecision(2) << seconds * 1e6 << " us"
+    << std::setw(12) << std::setprecision(2) << seconds * 1e9 / vertexCount << " ns/vertex"
+    << std::setw(10) << std::setprecision(2) << baseline / seconds << "x"
+    << "    checksum " << std::setprecision(3) << checksum << std::endl;
+}
+
+void PrintSweepRow(const Result& result)
+{
+  std::cout << std::left << std::setw(36) << result.name << std::right
+    << std::setw(12) << std::fixed << std::setprecision(3) << result.seconds * 1e3 << " ms"
+    << std::setw(12) << std::setprecision(2) << result.seconds * 1e9 / result.itemCount << " ns/curve" << std::endl;
+}
+
+// Budget limits the tree rather than its length, so any curve count is reached with the same growth order
+glar::scene::Fractal::CreateInfo SweepCreateInfo(uint32_t curveCount)
+{
+  glar::scene::Fractal::CreateInfo createInfo;
+  createInfo.maxLength = 40.f;
+  createInfo.maxCurveCount = curveCount;
+  return createInfo;
+}
+
+// Fewer iterations for larger inputs, so that each size takes about as long
+int SweepIterations(int iterations, uint32_t curveCount)
+{
+  const auto scaled = static_cast<int64_t>(iterations) * 1000 / curveCount;
+  return static_cast<int>(std::min<int64_t>(std::max<int64_t>(scaled, 1), iterations));
+}
+
+// One result per line, read back by ReadJson()
+void WriteJson(const std::string& filepath, int iterations, const std::vector<Result>& results)
+{
+  std::ofstream out(filepath);
+  if (!out)
+    throw std::runtime_error("Failed to write results: " + filepath);
+
+  out << "{" << std::endl
+    << "  \"iterations\": " << iterations << "," << std::endl
+    << "  \"results\": [" << std::endl;
+
+  out << std::setprecision(9);
+  for (size_t i = 0; i < results.size(); i++)
+  {
+    const auto& result = results[i];
+    out << "    { \"name\": \"" << result.name << "\", \"seconds\": " << result.seconds
+      << ", \"items\": " << result.itemCount << " }" << (i + 1 < results.size() ? "," : "") << std::endl;
+  }
+
+  out << "  ]" << std::endl
+    << "}" << std::endl;
+}
+
+// Seconds by result name, from a file written by WriteJson()
+std::map<std::string, double> ReadJson(const std::string& filepath)
+{
+  std::ifstream in(filepath);
+  if (!in)
+    throw std::runtime_error("Failed to read baseline: " + filepath);
+
+  const std::string nameKey = "\"name\": \"";
+  const std::string secondsKey = "\"seconds\": ";
+
+  std::map<std::string, double> seconds;
+  std::string line;
+  while (std::getline(in, line))
+  {
+    const auto nameBegin = line.find(nameKey);
+    const auto secondsBegin = line.find(secondsKey);
+    if (nameBegin == std::string::npos || secondsBegin == std::string::npos)
+      continue;
+
+    const auto nameStart = nameBegin + nameKey.size();
+    const auto name = line.substr(nameStart, line.find('"', nameStart) - nameStart);
+    seconds[name] = std::stod(line.substr(secondsBegin + secondsKey.size()));
+  }
+  return seconds;
+}
+
+// Returns the number of results slower than the baseline by more than the tolerance
+int CompareWithBaseline(const std::vector<Result>& results, const std::map<std::string, double>& baseline, double tolerance)
+{
+  std::cout << std::endl;
+  std::cout << "comparison with baseline, tolerance " << std::setprecision(0) << tolerance * 100. << "%:" << std::endl;
+
+  int regressionCount = 0;
+  for (const auto& result : results)
+  {
+    const auto it = baseline.find(result.name);
+    if (it == baseline.end())
+    {
+      std::cout << std::left << std::setw(36) << result.name << std::right << "    not in baseline" << std::endl;
+      continue;
+    }
+
+    const auto ratio = result.seconds / it->second;
+    const auto regression = ratio > 1. + tolerance;
+    if (regression)
+      regressionCount++;
+
+    std::cout << std::left << std::setw(36) << result.name << std::right
+      << std::setw(10) << std::setprecision(2) << ratio << "x"
+      << (regression ? "    REGRESSION" : ratio < 1. - tolerance ? "    improved" : "") << std::endl;
+  }
+
+  std::cout << regressionCount << " regressions" << std::endl;
+  return regressionCount;
+}
+
+void PrintUsage()
+{
+  std::cerr << "Usage: glar_benchmark [iterations] [--max-curves 100000] [--json results.json] [--baseline baseline.json] [--tolerance 0.1]" << std::endl;
+}
+}
+
+int main(int argc, char** argv)
+{
+  int iterations = 200;
+  // Mesh buffers of the sweep are sized for the worst case, about 10 KB per curve
+  uint32_t maxCurveCount = 100000;
+  std::string jsonFilepath;
+  std::string baselineFilepath;
+  double tolerance = 0.1;
+  for (int i = 1; i < argc; i++)
+  {
+    const std::string arg = argv[i];
+    if (arg.compare(0, 2, "--") != 0)
+      iterations = std::stoi(arg);
+    else if (i + 1 >= argc)
+    {
+      PrintUsage();
+      return 1;
+    }
+    else if (arg == "--json")
+      jsonFilepath = argv[++i];
+    else if (arg == "--baseline")
+      baselineFilepath = argv[++i];
+    else if (arg == "--tolerance")
+      tolerance = std::stod(argv[++i]);
+    else if (arg == "--max-curves")
+      maxCurveCount = static_cast<uint32_t>(std::stoul(argv[++i]));
+    else
+    {
+      PrintUsage();
+      return 1;
+    }
+  }
+
+  std::vector<Result> results;
+
+  glar::scene::Fractal::CreateInfo createInfo;
+  const auto createStart = Clock::now();
+  glar::scene::Fractal fractal(createInfo, 23);
+  const auto createSeconds = std::chrono::duration<double>(Clock::now() - createStart).count();
+
+  // Trees must not depend on the thread count
+  const auto serialStart = Clock::now();
+  glar::scene::Fractal serialFractal(createInfo, 23, 1);
+  const auto serialSeconds = std::chrono::duration<double>(Clock::now() - serialStart).count();
+  const auto identical = serialFractal.curves().size() == fractal.curves().size() &&
+    std::memcmp(serialFractal.curves().data(), fractal.curves().data(), sizeof(glar::scene::Fractal::Curve) * fractal.curves().size()) == 0;
+
+  // Full length rings of every curve
+  const auto stepCount = createInfo.steps + 1;
+  const auto vertexCount = fractal.curves().size() * stepCount * ringSize;
+  std::vector<float> vertices(6 * vertexCount);
+  const std::vector<float> ringScales(stepCount, 1.f);
+
+  std::cout << "fractal: " << fractal.curves().size() << " curves, " << vertexCount << " ring vertices, created in "
+    << createSeconds * 1e3 << " ms" << std::endl;
+  std::cout << "single-threaded creation: " << serialSeconds * 1e3 << " ms, " << (identical ? "identical" : "DIFFERENT") << " tree" << std::endl;
+  std::cout << "best instruction set: " << glar::scene::ToString(glar::scene::BestRingTransformIsa()) << std::endl;
+  std::cout << std::endl;
+
+  const auto baseline = Measure(iterations, [&]() { RebuildRings(fractal, vertices.data()); });
+  PrintRow("rebuild", baseline, baseline, vertexCount, Checksum(vertices));
+  results.push_back({ "rings.rebuild", baseline, vertexCount });
+
+  for (auto isa : { glar::scene::RingTransformIsa::SCALAR, glar::scene::RingTransformIsa::SSE, glar::scene::RingTransformIsa::AVX })
+  {
+    if (static_cast<int>(isa) > static_cast<int>(glar::scene::BestRingTransformIsa()))
+      continue;
+
+    const auto seconds = Measure(iterations, [&]() { TableRings(fractal, ringScales.data(), vertices.data(), isa); });
+    PrintRow(std::string("table ") + glar::scene::ToString(isa), seconds, baseline, vertexCount, Checksum(vertices));
+    results.push_back({ std::string("rings.table.") + glar::scene::ToString(isa), seconds, vertexCount });
+  }
+
+  // Whole mesh at the longest curves, including tips and blossoms
+  glar::scene::FractalMesh mesh(fractal);
+  std::vector<float> meshVertices(glar::scene::FractalMesh::vertexSize * static_cast<size_t>(mesh.MaxVertexCount()));
+  std::vector<uint32_t> meshIndices(mesh.MaxIndexCount());
+
+  constexpr float peakTime = 2.5f;
+  glar::scene::FractalMesh::Counts counts;
+  const auto meshSeconds = Measure(iterations, [&]() { counts = mesh.Generate(peakTime, meshVertices.data(), meshIndices.data()); });
+
+  std::cout << std::endl;
+  std::cout << "mesh: " << counts.vertexCount << " vertices, " << counts.indexCount << " indices, "
+    << std::setprecision(3) << meshSeconds * 1e3 << " ms" << std::endl;
+  results.push_back({ "mesh.default", meshSeconds, counts.vertexCount });
+
+  // Each ring size runs its own instantiation of the tube kernel
+  for (const auto tubeRingSize : glar::scene::FractalMesh::ringSizes)
+  {
+    const glar::scene::FractalMesh tubeMesh(fractal, tubeRingSize);
+    std::vector<float> tubeVertices(glar::scene::FractalMesh::vertexSize * static_cast<size_t>(tubeMesh.MaxVertexCount()));
+    std::vector<uint32_t> tubeIndices(tubeMesh.MaxIndexCount());
+
+    glar::scene::FractalMesh::Counts tubeCounts;
+    const auto seconds = Measure(iterations, [&]() { tubeCounts = tubeMesh.Generate(peakTime, tubeVertices.data(), tubeIndices.data()); });
+
+    std::cout << "mesh, " << std::setw(2) << tubeRingSize << " tube sides: " << tubeCounts.vertexCount << " vertices, "
+      << tubeCounts.indexCount << " indices, " << seconds * 1e3 << " ms" << std::endl;
+    results.push_back({ "mesh.tube." + std::to_string(tubeRingSize), seconds, tubeCounts.vertexCount });
+  }
+
+  // Creation and CPU mesh generation by curve count. The mesh is written to plain memory, so no GL context is needed,
+  // and upload is left out.
+  std::cout << std::endl;
+  for (const auto curveCount : sweepCurveCounts)
+  {
+    if (curveCount > maxCurveCount)
+      break;
+
+    const auto sweepCreateInfo = SweepCreateInfo(curveCount);
+    const auto sweepIterations = SweepIterations(iterations, curveCount);
+    const auto prefix = std::to_string(curveCount);
+
+    double serialSeconds;
+    double parallelSeconds;
+    std::unique_ptr<glar::scene::Fractal> sweepFractal;
+    bool sweepIdentical;
+    {
+      MutedOutput muted;
+      serialSeconds = Measure(sweepIterations, [&]() { const glar::scene::Fractal created(sweepCreateInfo, 23, 1); });
+      parallelSeconds = Measure(sweepIterations, [&]() { const glar::scene::Fractal created(sweepCreateInfo, 23); });
+
+      sweepFractal = std::make_unique<glar::scene::Fractal>(sweepCreateInfo, 23);
+      const glar::scene::Fractal serialSweepFractal(sweepCreateInfo, 23, 1);
+      sweepIdentical = serialSweepFractal.curves().size() == sweepFractal->curves().size() &&
+        std::memcmp(serialSweepFractal.curves().data(), sweepFractal->curves().data(),
+          sizeof(glar::scene::Fractal::Curve) * sweepFractal->curves().size()) == 0;
+    }
+
+    const auto actualCurveCount = sweepFractal->curves().size();
+    results.push_back({ "fractal.create.serial." + prefix, serialSeconds, actualCurveCount });
+    PrintSweepRow(results.back());
+    results.push_back({ "fractal.create.parallel." + prefix, parallelSeconds, actualCurveCount });
+    PrintSweepRow(results.back());
+    if (!sweepIdentical)
+      std::cout << "parallel creation grew a DIFFERENT tree" << std::endl;
+
+    const glar::scene::FractalMesh sweepMesh(*sweepFractal);
+    std::vector<float> sweepVertices(glar::scene::FractalMesh::vertexSize * static_cast<size_t>(sweepMesh.MaxVertexCount()));
+    std::vector<uint32_t> sweepIndices(sweepMesh.MaxIndexCount());
+    for (const auto animationTime : sweepAnimationTimes)
+    {
+      std::ostringstream name;
+      name << "mesh.generate." << prefix << ".t" << std::fixed << std::setprecision(2) << animationTime;
+
+      const auto seconds = Measure(sweepIterations, [&]() { sweepMesh.Generate(animationTime, sweepVertices.data(), sweepIndices.data()); });
+      results.push_back({ name.str(), seconds, actualCurveCount });
+      PrintSweepRow(results.back());
+    }
+  }
+
+  if (!jsonFilepath.empty())
+  {
+    WriteJson(jsonFilepath, iterations, results);
+    std::cout << std::endl << "results written to " << jsonFilepath << std::endl;
+  }
+
+  // Non-zero exit code on regressions, for scripts
+  if (!baselineFilepath.empty() && CompareWithBaseline(results, ReadJson(baselineFilepath), tolerance) > 0)
+    return 1;
+
+  return 0;
+}
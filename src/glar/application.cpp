@@ -6,8 +6,9 @@
 #include <thread>
 #include <string>
 #include <fstream>
-#include <sstream>
 #include <filesystem>
+#include <algorithm>
+#include <cmath>
 
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
@@ -24,12 +25,20 @@
 #include <imgui_impl_glfw.h>
 #include <imgui_impl_opengl3.h>
 
-#include <glar/gl/geometry.h>
-#include <glar/gl/shader.h>
+#include <glar/batch_processor.h>
+#include <glar/frame_recorder.h>
+#include <glar/renderer.h>
 #include <glar/gl/texture.h>
-#include <glar/sensor/video_capture.h>
+#include <glar/ipc/pose_publisher.h>
+#include <glar/sensor/frame_source.h>
 #include <glar/scene/fractal.h>
-#include <glar/scene/fractal_geometry.h>
+#include <glar/telemetry/log_writer.h>
+#include <glar/util/allocation_counter.h>
+#include <glar/util/i420.h>
+#include <glar/util/pooled_mat_allocator.h>
+#include <glar/util/text_stream.h>
+#include <glar/vision/detection_scheduler.h>
+#include <glar/vision/marker_detector.h>
 
 namespace glar
 {
@@ -38,12 +47,283 @@ namespace
 const std::string executableDirpath = "C:\\workspace\\glar\\bin";
 const auto iniFilepath = executableDirpath + "\\imgui.ini";
 const auto calibFilepath = executableDirpath + "\\calib.txt";
+const auto fractalCacheFilepath = executableDirpath + "\\fractal.bin";
+const auto detectorParametersFilepath = executableDirpath + "\\detector_params.yml";
+const auto recordingFilepath = executableDirpath + "\\recording.mp4";
+const auto telemetryFilepath = executableDirpath + "\\telemetry.bin";
+const std::string shaderDirpath = "C:\\workspace\\glar\\src\\glar\\shader";
+
+// ArUco marker size
+constexpr float markerSize = 0.042f; // 4.2cm
+
+// The same tree on every run
+constexpr uint32_t fractalSeed = 23;
+
+// Keeps frame time bounded whatever the fractal parameters are
+constexpr uint32_t fractalMaxTriangleCount = 500000;
+
+// ImGui takes a few frames to settle hover and active states after input
+constexpr int inputRedrawFrames = 3;
+
+// Stats text is refreshed at least this often when nothing else changes
+constexpr double maxRedrawInterval = 1.; // 1s
+
+// Weight of a new frame in the allocation averages
+constexpr double allocationAverageWeight = 0.1;
+
+// Largest frame published to other processes, larger frames are left out
+constexpr uint64_t publishedFrameCapacity = 1920 * 1080 * 3;
+
+struct CameraStream
+{
+  std::string address;
+  std::unique_ptr<sensor::FrameSource> capture;
+  int detectionStream = 0;
+
+  // Taken detection results are swapped with this one, so its buffers are reused
+  vision::DetectionScheduler::Result result;
+
+  gl::Texture texture;
+  glm::mat4 model = glm::mat4(1.f);
+};
+
+enum class FrameStage
+{
+  UI,
+  FRAMES,
+  RESULTS,
+  RENDER,
+  DETECTION,
+  OTHER_THREADS,
+};
+
+constexpr int frameStageCount = 6;
+
+const char* ToString(FrameStage stage)
+{
+  switch (stage)
+  {
+  case FrameStage::UI: return "UI";
+  case FrameStage::FRAMES: return "Camera frames";
+  case FrameStage::RESULTS: return "Detection results";
+  case FrameStage::RENDER: return "Render";
+  case FrameStage::DETECTION: return "Detection workers";
+  case FrameStage::OTHER_THREADS: return "Other threads";
+  default: return "Unknown";
+  }
+}
+
+// Poses and frame of a detection result, timestamped with the clock shared by all processes
+void PublishResult(ipc::PosePublisher& publisher, int stream, const vision::DetectionScheduler::Result& result)
+{
+  const auto age = std::chrono::high_resolution_clock::now() - result.captureTime;
+  const auto captureTime = ipc::Now() - std::chrono::duration_cast<std::chrono::nanoseconds>(age).count();
+
+  auto frameSequence = ~0ull;
+  const auto& image = result.image;
+  if (publisher.PublishesFrames() && !image.empty() && image.isContinuous())
+  {
+    const auto size = util::FrameSize(image);
+
+    ipc::FrameInfo info;
+    info.captureTime = captureTime;
+    info.stream = stream;
+    info.format = util::IsI420(image) ? ipc::FrameFormat::I420 : ipc::FrameFormat::BGR;
+    info.width = size.width;
+    info.height = size.height;
+    info.size = image.total() * image.elemSize();
+    frameSequence = publisher.PublishFrame(info, image.data);
+  }
+
+  const auto& detection = result.detection;
+  for (int i = 0; i < detection.tvecs.size(); i++)
+  {
+    ipc::PoseRecord record;
+    record.frameSequence = frameSequence;
+    record.captureTime = captureTime;
+    record.stream = stream;
+    record.markerId = detection.ids[i];
+    for (int j = 0; j < 3; j++)
+    {
+      record.rvec[j] = detection.rvecs[i][j];
+      record.tvec[j] = detection.tvecs[i][j];
+    }
+    publisher.PublishPose(record);
+  }
+}
+
+void LogResult(telemetry::LogWriter& log, uint64_t frame, int stream, const vision::DetectionScheduler::Result& result,
+  std::chrono::high_resolution_clock::time_point takeTime)
+{
+  const auto& detection = result.detection;
+
+  telemetry::DetectionRecord record;
+  record.frame = frame;
+  record.captureTime = log.Timestamp(result.captureTime);
+  record.detectionStartTime = log.Timestamp(result.detectionStartTime);
+  record.detectionEndTime = log.Timestamp(result.detectionEndTime);
+  record.takeTime = log.Timestamp(takeTime);
+  record.stream = stream;
+  record.markerCount = static_cast<uint32_t>(detection.ids.size());
+  log.Write(record);
+
+  for (int i = 0; i < detection.tvecs.size(); i++)
+  {
+    telemetry::PoseRecord pose;
+    pose.frame = frame;
+    pose.stream = stream;
+    pose.markerId = detection.ids[i];
+    for (int j = 0; j < 3; j++)
+    {
+      pose.rvec[j] = detection.rvecs[i][j];
+      pose.tvec[j] = detection.tvecs[i][j];
+    }
+    log.Write(pose);
+  }
+}
+
+/**
+* Durations of the stages of the frame loop, for the telemetry log
+*/
+class FrameTimes
+{
+public:
+  using Clock = std::chrono::high_resolution_clock;
+
+  void BeginFrame()
+  {
+    startTime_ = Clock::now();
+    stageStartTime_ = startTime_;
+  }
+
+  // Stages on this thread end one after another
+  void EndStage(FrameStage stage)
+  {
+    const auto time = Clock::now();
+    durations_[static_cast<int>(stage)] = time - stageStartTime_;
+    stageStartTime_ = time;
+  }
+
+  void Log(telemetry::LogWriter& log, uint64_t frame, bool skipped, size_t streamCount) const
+  {
+    const auto nanoseconds = [this](FrameStage stage)
+    {
+      return std::chrono::duration_cast<std::chrono::nanoseconds>(durations_[static_cast<int>(stage)]).count();
+    };
+
+    telemetry::FrameRecord record;
+    record.frame = frame;
+    record.startTime = log.Timestamp(startTime_);
+    record.uiTime = nanoseconds(FrameStage::UI);
+    record.framesTime = nanoseconds(FrameStage::FRAMES);
+    record.resultsTime = nanoseconds(FrameStage::RESULTS);
+    record.renderTime = nanoseconds(FrameStage::RENDER);
+    record.skipped = skipped ? 1 : 0;
+    record.streamCount = static_cast<uint32_t>(streamCount);
+    log.Write(record);
+  }
+
+private:
+  Clock::time_point startTime_;
+  Clock::time_point stageStartTime_;
+  Clock::duration durations_[frameStageCount] = {};
+};
+
+/**
+* Heap allocations per frame by stage of the frame loop, averaged over frames
+*/
+class FrameAllocations
+{
+public:
+  struct Average
+  {
+    double count = 0.;
+    double bytes = 0.;
+  };
+
+public:
+  void Reset()
+  {
+    for (auto& average : averages_)
+      average = {};
+  }
+
+  void BeginFrame(const util::AllocationCounts& detectionCounts)
+  {
+    stageStartCounts_ = util::AllocationCounter::ThreadCounts();
+    frameStartCounts_ = stageStartCounts_;
+    totalStartCounts_ = util::AllocationCounter::TotalCounts();
+    detectionStartCounts_ = detectionCounts;
+  }
+
+  // Stages on this thread end one after another
+  void EndStage(FrameStage stage)
+  {
+    const auto counts = util::AllocationCounter::ThreadCounts();
+    Update(stage, counts - stageStartCounts_);
+    stageStartCounts_ = counts;
+  }
+
+  // Detection counts are added when a detection finishes, so frames are attributed approximately
+  void EndFrame(const util::AllocationCounts& detectionCounts)
+  {
+    const auto detection = detectionCounts - detectionStartCounts_;
+    Update(FrameStage::DETECTION, detection);
+
+    const auto total = util::AllocationCounter::TotalCounts() - totalStartCounts_;
+    const auto thisThread = util::AllocationCounter::ThreadCounts() - frameStartCounts_;
+    util::AllocationCounts other;
+    if (total.count > thisThread.count + detection.count)
+      other.count = total.count - thisThread.count - detection.count;
+    if (total.bytes > thisThread.bytes + detection.bytes)
+      other.bytes = total.bytes - thisThread.bytes - detection.bytes;
+    Update(FrameStage::OTHER_THREADS, other);
+  }
+
+  const Average& average(FrameStage stage) const { return averages_[static_cast<int>(stage)]; }
+
+private:
+  void Update(FrameStage stage, const util::AllocationCounts& counts)
+  {
+    auto& average = averages_[static_cast<int>(stage)];
+    average.count += allocationAverageWeight * (counts.count - average.count);
+    average.bytes += allocationAverageWeight * (counts.bytes - average.bytes);
+  }
+
+  Average averages_[frameStageCount];
+
+  util::AllocationCounts stageStartCounts_;
+  util::AllocationCounts frameStartCounts_;
+  util::AllocationCounts totalStartCounts_;
+  util::AllocationCounts detectionStartCounts_;
+};
 
 void ErrorCallback(int error, const char* description)
 {
   fprintf(stderr, "Error: %s\n", description);
 }
 
+Application* GetApplication(GLFWwindow* window)
+{
+  return static_cast<Application*>(glfwGetWindowUserPointer(window));
+}
+
+// I420 frames are uploaded as planes and converted to RGB when drawn
+void UploadFrame(gl::Texture& texture, const cv::Mat& frame)
+{
+  const auto size = util::FrameSize(frame);
+  if (util::IsI420(frame))
+  {
+    texture.UpdateStorage(size.width, size.height, gl::Texture::Format::I420);
+    texture.UpdateI420(frame.ptr());
+  }
+  else
+  {
+    texture.UpdateStorage(size.width, size.height);
+    texture.Update(const_cast<uint8_t*>(frame.ptr()), GL_BGR);
+  }
+}
+
 void SaveCalibration(cv::Mat cameraMatrix, cv::Mat distortion)
 {
   std::ofstream out(calibFilepath);
@@ -126,6 +406,16 @@ Application::Application()
   // Callbacks
   glfwSetWindowUserPointer(window_, this);
 
+  // Installed before ImGui, which chains them
+  glfwSetCursorPosCallback(window_, [](GLFWwindow* window, double, double) { GetApplication(window)->Damage(); });
+  glfwSetCursorEnterCallback(window_, [](GLFWwindow* window, int) { GetApplication(window)->Damage(); });
+  glfwSetMouseButtonCallback(window_, [](GLFWwindow* window, int, int, int) { GetApplication(window)->Damage(); });
+  glfwSetScrollCallback(window_, [](GLFWwindow* window, double, double) { GetApplication(window)->Damage(); });
+  glfwSetKeyCallback(window_, [](GLFWwindow* window, int, int, int, int) { GetApplication(window)->Damage(); });
+  glfwSetCharCallback(window_, [](GLFWwindow* window, unsigned int) { GetApplication(window)->Damage(); });
+  glfwSetWindowFocusCallback(window_, [](GLFWwindow* window, int) { GetApplication(window)->Damage(); });
+  glfwSetWindowRefreshCallback(window_, [](GLFWwindow* window) { GetApplication(window)->Damage(); });
+
   glfwMakeContextCurrent(window_);
 
   if (!gladLoadGL())
@@ -155,6 +445,11 @@ Application::~Application()
   glfwTerminate();
 }
 
+void Application::Damage()
+{
+  inputFrames_ = inputRedrawFrames;
+}
+
 void Application::CreateDetectionMarker()
 {
   // Create ArUco marker
@@ -182,57 +477,37 @@ void Application::CreateCalibrationBoard()
 
 void Application::Run()
 {
-  const std::string shaderDirpath = "C:\\workspace\\glar\\src\\glar\\shader";
-  gl::Shader cameraShader(shaderDirpath, "camera");
-  gl::Shader colorShader(shaderDirpath, "color");
-  gl::Shader phongShader(shaderDirpath, "phong");
-
-  // AR matrices
-  constexpr float near = 0.01f;
-  constexpr float far = 10.f;
-  auto model = glm::mat4(1.f);
-
-  // Rect geometry
-  gl::Geometry rectGeometry(
-    { 0.f, 0.f, 1.f, 0.f, 0.f, 1.f, 1.f, 1.f },
-    { {0, 2, 2, 0} },
-    { 0, 1, 2, 2, 1, 3 },
-    GL_TRIANGLES
-  );
-
-  // Axis geometry
-  gl::Geometry axisGeometry(
-    {
-      0.f, 0.f, 0.f, 1.f, 0.f, 0.f,
-      1.f, 0.f, 0.f, 1.f, 0.f, 0.f,
-      0.f, 0.f, 0.f, 0.f, 1.f, 0.f,
-      0.f, 1.f, 0.f, 0.f, 1.f, 0.f,
-      0.f, 0.f, 0.f, 0.f, 0.f, 1.f,
-      0.f, 0.f, 1.f, 0.f, 0.f, 1.f,
-    },
-    {
-      {0, 3, 6, 0},
-      {1, 3, 6, 3},
-    },
-    { 0, 1, 2, 3, 4, 5 },
-    GL_LINES
-    );
-
-  // Fractal
+  // Scene
   scene::Fractal::CreateInfo fractalCreateInfo;
-  scene::Fractal fractal(fractalCreateInfo);
-  scene::FractalGeometry fractalGeometry(fractal);
+  fractalCreateInfo.maxTriangleCount = fractalMaxTriangleCount;
+  Renderer renderer(shaderDirpath, scene::Fractal::LoadOrCreate(fractalCacheFilepath, fractalCreateInfo, fractalSeed));
 
-  // ArUco dictionary
-  cv::Ptr<cv::aruco::DetectorParameters> parameters = cv::aruco::DetectorParameters::create();
-  cv::Ptr<cv::aruco::Dictionary> dictionary = cv::aruco::getPredefinedDictionary(cv::aruco::DICT_6X6_250);
+  // Fractal meshes are generated while the previous frame is drawn
+  scene::FractalSimulation::CreateInfo simulationCreateInfo;
+  renderer.SetFractalSimulation(simulationCreateInfo);
+
+  // ArUco detector
+  vision::MarkerDetector detector(markerSize);
+  if (detector.LoadParameters(detectorParametersFilepath))
+    std::cout << "Detector parameters loaded from " << detectorParametersFilepath << std::endl;
+  vision::MarkerDetection detection;
 
-  // ArUco marker size
-  constexpr float markerSize = 0.042; // 4.2cm
+  // Detection of all camera streams is shared by a fixed number of workers
+  const int detectionWorkerCount = std::max(1, static_cast<int>(std::thread::hardware_concurrency()) / 2);
+  vision::DetectionScheduler scheduler(detector, detectionWorkerCount);
 
-  // Video stream
+  // Video streams, each drawn in its own tile
   char videoStreamAddress[256] = { 0, };
-  std::unique_ptr<sensor::VideoCapture> vcap;
+  std::vector<std::unique_ptr<CameraStream>> streams;
+
+  // Recording of the composited scene
+  std::unique_ptr<FrameRecorder> recorder;
+
+  // Poses, and optionally frames, for other processes
+  std::unique_ptr<ipc::PosePublisher> publisher;
+
+  // Frame timings and detection results for offline analysis
+  std::unique_ptr<telemetry::LogWriter> telemetryLog;
 
   // Calibration
   std::chrono::high_resolution_clock::time_point calibrationCaptureTime;
@@ -246,21 +521,39 @@ void Application::Run()
 
   // The initial calibration matrix
   LoadCalibration(cameraMatrix, distortion);
-
-  // Camera image texture
-  gl::Texture cameraTexture;
+  detector.SetCameraParameters(cameraMatrix, distortion);
 
   uint64_t frameCount = 0;
+  uint64_t skippedFrameCount = 0;
   const auto startTime = std::chrono::high_resolution_clock::now();
   auto animationStartTime = std::chrono::high_resolution_clock::now();
+  auto drawTime = startTime;
   uint64_t seconds = 0;
+
+  // Frame-sized Mats of all threads are reused instead of allocated every frame
+  const auto& matAllocator = util::PooledMatAllocator::InstallDefault();
+  FrameAllocations frameAllocations;
+  FrameTimes frameTimes;
+
+  // Stats text, rebuilt every frame in the same buffer
+  util::TextStream text;
+
+  // Draw the first frames
+  Damage();
+
   while (!glfwWindowShouldClose(window_))
   {
+    frameAllocations.BeginFrame(scheduler.Allocations());
+    frameTimes.BeginFrame();
+
     glfwPollEvents();
 
     const auto currentTime = std::chrono::high_resolution_clock::now();
     const auto elapsed = std::chrono::duration<double>(currentTime - startTime).count();
 
+    // Frame is drawn only when something on screen changed since the last drawn frame
+    bool damaged = inputFrames_ > 0 || std::chrono::duration<double>(currentTime - drawTime).count() >= maxRedrawInterval;
+
     ImGui_ImplOpenGL3_NewFrame();
     ImGui_ImplGlfw_NewFrame();
     ImGui::NewFrame();
@@ -273,24 +566,145 @@ void Application::Run()
 
       ImGui::Text("(ex. http://192.168.0.12:62225)");
 
+      // Native MJPEG client decodes newest frames only, optionally downscaled. Calibrate at the same scale.
+      // YUV frames skip color conversions, and detection overlays are drawn in grayscale.
+      static bool nativeMjpeg = false;
+      static int scaleIndex = 0;
+      static bool yuvFrames = false;
+      constexpr const char* scaleNames[] = { "1/1", "1/2", "1/4", "1/8" };
+
+      ImGui::Checkbox("Native MJPEG client", &nativeMjpeg);
+      if (nativeMjpeg)
+      {
+        ImGui::Combo("Decode scale", &scaleIndex, scaleNames, IM_ARRAYSIZE(scaleNames));
+        ImGui::Checkbox("Planar YUV frames", &yuvFrames);
+      }
+
       if (ImGui::Button("Connect"))
-        vcap = std::make_unique<sensor::VideoCapture>(videoStreamAddress);
+      {
+        sensor::FrameSource::CreateInfo sourceCreateInfo;
+        sourceCreateInfo.type = nativeMjpeg ? sensor::FrameSource::Type::MJPEG : sensor::FrameSource::Type::OPENCV;
+        sourceCreateInfo.scaleDenominator = 1 << scaleIndex;
+        sourceCreateInfo.i420 = yuvFrames;
+
+        auto stream = std::make_unique<CameraStream>();
+        stream->address = videoStreamAddress;
+        stream->capture = sensor::FrameSource::Create(videoStreamAddress, sourceCreateInfo);
+        stream->detectionStream = scheduler.AddStream();
+        streams.push_back(std::move(stream));
+      }
+
+      int disconnectIndex = -1;
+      for (int i = 0; i < streams.size(); i++)
+      {
+        ImGui::PushID(i);
+        ImGui::Text("Camera %d: %s", i, streams[i]->address.c_str());
+        ImGui::SameLine();
+        if (ImGui::Button("Disconnect"))
+          disconnectIndex = i;
+        ImGui::PopID();
+      }
+
+      if (disconnectIndex >= 0)
+      {
+        scheduler.RemoveStream(streams[disconnectIndex]->detectionStream);
+        streams.erase(streams.begin() + disconnectIndex);
+      }
 
       ImGui::Separator();
     }
 
     {
-      std::ostringstream ss;
-      ss  << "Graphics FPS: " << frameCount / elapsed << std::endl;
+      text.Clear();
+      text << "Graphics FPS: " << (frameCount - skippedFrameCount) / elapsed << std::endl;
+      if (frameCount > 0)
+        text << "Skipped frames: " << 100. * skippedFrameCount / frameCount << "%" << std::endl;
 
-      if (vcap)
+      for (int i = 0; i < streams.size(); i++)
       {
-        ss
-          << "Stream   FPS: " << vcap->TargetFps() << std::endl
-          << "Actual   FPS: " << vcap->Fps();
+        const auto captureStats = streams[i]->capture->Stats();
+        const auto stats = scheduler.Stats(streams[i]->detectionStream);
+
+        text
+          << "Camera " << i << std::endl
+          << "  Stream   FPS: " << captureStats.targetFps << std::endl
+          << "  Actual   FPS: " << captureStats.fps << std::endl
+          << "  Read/decode : " << captureStats.averageReadTime * 1000. << "ms / " << captureStats.averageDecodeTime * 1000. << "ms" << std::endl
+          << "  Stall       : " << captureStats.stallDuration << "s (max " << captureStats.maxStallDuration << "s), "
+          << captureStats.reconnectCount << " reconnects" << std::endl;
+
+        // Non-empty bins of frame interval jitter
+        text << "  Jitter      :";
+        for (int bin = 0; bin < sensor::FrameSourceStats::jitterBinCount; bin++)
+        {
+          if (captureStats.jitterHistogram[bin] == 0)
+            continue;
+
+          if (bin + 1 < sensor::FrameSourceStats::jitterBinCount)
+            text << " <" << sensor::FrameSourceStats::jitterBinBounds[bin] * 1000. << "ms:";
+          else
+            text << " >" << sensor::FrameSourceStats::jitterBinBounds[bin - 1] * 1000. << "ms:";
+          text << captureStats.jitterHistogram[bin];
+        }
+        text << std::endl;
+
+        text
+          << "  Latency     : " << stats.averageLatency * 1000. << "ms (max " << stats.maxLatency * 1000. << "ms)" << std::endl
+          << "  Detection   : " << stats.averageDetectionTime * 1000. << "ms" << std::endl
+          << "  Processed   : " << stats.processedFrames << " (" << stats.share * 100. << "%), dropped " << stats.droppedFrames << std::endl;
+
+        const auto trackerStats = scheduler.TrackerStats(streams[i]->detectionStream);
+        if (trackerStats.frameCount > 0)
+        {
+          text
+            << "  Full detect : " << 100. * trackerStats.detectionCount / trackerStats.frameCount << "% of frames, "
+            << trackerStats.lostCount << " lost" << std::endl
+            << "  Track/detect: " << trackerStats.averageTrackingTime * 1000. << "ms / " << trackerStats.averageDetectionTime * 1000. << "ms" << std::endl;
+        }
+
+        const auto poseStats = scheduler.PoseStats(streams[i]->detectionStream);
+        if (poseStats.markerCount > 0)
+        {
+          text
+            << "  Pose solve  : " << poseStats.averageSolveTime * 1000000. << "us/marker" << std::endl
+            << "  Reprojection: " << poseStats.averageReprojectionError << "px (max " << poseStats.maxReprojectionError << "px)" << std::endl;
+        }
       }
 
-      ImGui::Text(ss.str().c_str());
+      if (!streams.empty())
+      {
+        text
+          << "Detection workers: " << scheduler.WorkerCount() << std::endl
+          << "Fairness index   : " << scheduler.FairnessIndex();
+      }
+
+      ImGui::TextUnformatted(text.c_str());
+    }
+
+    if (ImGui::CollapsingHeader("Allocations"))
+    {
+      static bool countAllocations = false;
+      if (ImGui::Checkbox("Count allocations", &countAllocations))
+      {
+        util::AllocationCounter::SetEnabled(countAllocations);
+        frameAllocations.Reset();
+      }
+
+      if (countAllocations)
+      {
+        ImGui::Text("Per frame:");
+        for (int i = 0; i < frameStageCount; i++)
+        {
+          const auto stage = static_cast<FrameStage>(i);
+          const auto& average = frameAllocations.average(stage);
+          ImGui::Text("  %-18s %8.1f %10.1fKB", ToString(stage), average.count, average.bytes / 1024.);
+        }
+      }
+
+      const auto matStats = matAllocator.stats();
+      ImGui::Text("Mat pool: %llu reused, %llu allocated, %.1fMB free",
+        static_cast<unsigned long long>(matStats.reuseCount), static_cast<unsigned long long>(matStats.allocationCount),
+        matStats.pooledBytes / static_cast<double>(1 << 20));
     }
 
     if (ImGui::CollapsingHeader("Calibration parameters", ImGuiTreeNodeFlags_DefaultOpen))
@@ -300,9 +714,7 @@ void Application::Run()
       {
         for (int j = 0; j < cameraMatrix.cols; j++)
         {
-          std::ostringstream ss;
-          ss << cameraMatrix.at<double>(i, j);
-          ImGui::Text(ss.str().c_str());
+          ImGui::Text("%g", cameraMatrix.at<double>(i, j));
           if (j + 1 < cameraMatrix.cols)
             ImGui::SameLine();
         }
@@ -313,9 +725,7 @@ void Application::Run()
       ImGui::Text("Distortion parameters:");
       for (int i = 0; i < distortion.cols; i++)
       {
-        std::ostringstream ss;
-        ss << distortion.at<double>(0, i);
-        ImGui::Text(ss.str().c_str());
+        ImGui::Text("%g", distortion.at<double>(0, i));
         if (i + 1 < distortion.cols)
           ImGui::SameLine();
       }
@@ -327,8 +737,7 @@ void Application::Run()
       {
         ImGui::Text("Calibrating, please wait...");
 
-        const auto progress = std::to_string(calibrationImages.size()) + " / " + std::to_string(requiredCalibrationImages);
-        ImGui::Text(progress.c_str());
+        ImGui::Text("%d / %d", static_cast<int>(calibrationImages.size()), requiredCalibrationImages);
 
         if (ImGui::Button("Cancel"))
           appMode_ = AppMode::DETECTION;
@@ -345,6 +754,110 @@ void Application::Run()
       ImGui::Separator();
     }
 
+    if (ImGui::CollapsingHeader("Pose Estimation", ImGuiTreeNodeFlags_DefaultOpen))
+    {
+      constexpr vision::PoseSolver::Type poseSolverTypes[] = {
+        vision::PoseSolver::Type::ITERATIVE,
+        vision::PoseSolver::Type::IPPE_SQUARE,
+        vision::PoseSolver::Type::TRACKING,
+      };
+
+      const auto currentType = scheduler.PoseSolverType();
+      if (ImGui::BeginCombo("Pose solver", vision::PoseSolver::ToString(currentType)))
+      {
+        for (auto type : poseSolverTypes)
+        {
+          if (ImGui::Selectable(vision::PoseSolver::ToString(type), type == currentType))
+            scheduler.SetPoseSolver(type);
+        }
+        ImGui::EndCombo();
+      }
+
+      // Optical flow between full detections
+      static bool tracking = false;
+      static vision::MarkerTracker::CreateInfo trackerCreateInfo;
+
+      bool trackingChanged = ImGui::Checkbox("Optical flow tracking", &tracking);
+      if (tracking)
+        trackingChanged |= ImGui::SliderInt("Detection interval", &trackerCreateInfo.detectionInterval, 1, 60);
+
+      if (trackingChanged)
+        scheduler.SetTracking(tracking, trackerCreateInfo);
+
+      ImGui::Separator();
+    }
+
+    if (ImGui::CollapsingHeader("Pose export"))
+    {
+      static bool publishPoses = false;
+      static bool publishFrames = false;
+
+      bool publisherChanged = ImGui::Checkbox("Publish to shared memory", &publishPoses);
+      if (publishPoses)
+        publisherChanged |= ImGui::Checkbox("Include frames", &publishFrames);
+
+      if (publisherChanged)
+      {
+        publisher = nullptr;
+        if (publishPoses)
+        {
+          try
+          {
+            ipc::PosePublisher::CreateInfo createInfo;
+            if (publishFrames)
+              createInfo.frameCapacity = publishedFrameCapacity;
+            publisher = std::make_unique<ipc::PosePublisher>(createInfo);
+          }
+          catch (const std::exception& e)
+          {
+            std::cerr << e.what() << std::endl;
+            publishPoses = false;
+          }
+        }
+      }
+
+      if (publisher)
+      {
+        const auto& stats = publisher->stats();
+        ImGui::Text("Channel %s: %llu poses, %llu frames", publisher->name().c_str(),
+          static_cast<unsigned long long>(stats.poseCount), static_cast<unsigned long long>(stats.frameCount));
+        if (stats.oversizedFrameCount > 0)
+          ImGui::Text("Frames too large to publish: %llu", static_cast<unsigned long long>(stats.oversizedFrameCount));
+      }
+    }
+
+    if (ImGui::CollapsingHeader("Telemetry"))
+    {
+      static bool logTelemetry = false;
+      if (ImGui::Checkbox("Log to file", &logTelemetry))
+      {
+        // The previous log is completed before a new one replaces the file
+        telemetryLog = nullptr;
+        if (logTelemetry)
+        {
+          try
+          {
+            telemetry::LogWriter::CreateInfo createInfo;
+            createInfo.filepath = telemetryFilepath;
+            telemetryLog = std::make_unique<telemetry::LogWriter>(createInfo);
+          }
+          catch (const std::exception& e)
+          {
+            std::cerr << e.what() << std::endl;
+            logTelemetry = false;
+          }
+        }
+      }
+
+      if (telemetryLog)
+      {
+        const auto stats = telemetryLog->stats();
+        ImGui::Text("%llu records, %.1f MB written", static_cast<unsigned long long>(stats.writtenCount), stats.writtenBytes / 1e6);
+        if (stats.droppedCount > 0)
+          ImGui::Text("Dropped, queue full: %llu", static_cast<unsigned long long>(stats.droppedCount));
+      }
+    }
+
     if (ImGui::CollapsingHeader("Rendering", ImGuiTreeNodeFlags_DefaultOpen))
     {
       if (appMode_ != AppMode::CALIBRATION)
@@ -363,24 +876,133 @@ void Application::Run()
         case 1: appMode_ = AppMode::AUGMENT; break;
         }
       }
+
+      static bool gpuFractal = false;
+      if (ImGui::Checkbox("GPU fractal generation", &gpuFractal))
+        renderer.SetFractalBackend(gpuFractal ? Renderer::FractalBackend::GPU : Renderer::FractalBackend::CPU);
+
+      // Off generates fractal meshes on the render thread, for comparison
+      static bool fractalSimulation = true;
+      static int simulationRate = static_cast<int>(std::round(1. / simulationCreateInfo.timeStep));
+
+      bool simulationChanged = ImGui::Checkbox("Fractal simulation thread", &fractalSimulation);
+      if (fractalSimulation)
+        simulationChanged |= ImGui::SliderInt("Simulation rate (Hz)", &simulationRate, 15, 240);
+
+      if (simulationChanged)
+      {
+        auto createInfo = simulationCreateInfo;
+        createInfo.timeStep = fractalSimulation ? 1. / simulationRate : 0.;
+        renderer.SetFractalSimulation(createInfo);
+      }
+
+      // More sides make rounder tubes for more vertices
+      const auto currentRingSize = renderer.fractalRingSize();
+      if (ImGui::BeginCombo("Tube sides", std::to_string(currentRingSize).c_str()))
+      {
+        for (auto ringSize : scene::FractalMesh::ringSizes)
+        {
+          if (ImGui::Selectable(std::to_string(ringSize).c_str(), ringSize == currentRingSize))
+            renderer.SetFractalRingSize(ringSize);
+        }
+        ImGui::EndCombo();
+      }
+
+      // Trades sharpness of the augmented scene for GPU time
+      static float overlayScale = 1.f;
+      if (ImGui::SliderFloat("Overlay scale", &overlayScale, 0.25f, 1.f, "%.2f"))
+        renderer.SetOverlayScale(overlayScale);
+
+      // Trades memory for CPU time of fractal generation
+      static bool fractalKeyframes = false;
+      static scene::FractalKeyframes::CreateInfo keyframeCreateInfo;
+      static int keyframeMemoryLimit = static_cast<int>(keyframeCreateInfo.memoryLimit >> 20);
+
+      bool keyframesChanged = ImGui::Checkbox("Fractal keyframe cache", &fractalKeyframes);
+      if (fractalKeyframes)
+      {
+        keyframesChanged |= ImGui::SliderInt("Keyframes per period", &keyframeCreateInfo.keyframeCount, 10, 600);
+        keyframesChanged |= ImGui::SliderInt("Keyframe memory (MB)", &keyframeMemoryLimit, 16, 2048);
+        keyframesChanged |= ImGui::Checkbox("Interpolate keyframes", &keyframeCreateInfo.interpolate);
+      }
+
+      if (keyframesChanged)
+      {
+        auto createInfo = keyframeCreateInfo;
+        createInfo.memoryLimit = static_cast<size_t>(keyframeMemoryLimit) << 20;
+        if (!fractalKeyframes)
+          createInfo.keyframeCount = 0;
+
+        renderer.SetFractalKeyframes(createInfo);
+      }
+
+      if (const auto keyframeStats = renderer.fractalKeyframeStats())
+      {
+        const auto& stats = *keyframeStats;
+        const auto frameCount = stats.hitCount + stats.interpolatedCount + stats.missCount;
+
+        text.Clear();
+        text
+          << "Keyframes: " << stats.storedCount << " stored of " << stats.keyframeCount / 2 + 1 << std::endl
+          << "Memory   : " << (stats.memoryUsage >> 20) << " / " << (stats.memoryLimit >> 20) << "MB" << std::endl
+          << "Frames   : " << stats.hitCount << " nearest, " << stats.interpolatedCount << " interpolated, "
+          << stats.missCount << " generated";
+        if (frameCount > 0)
+          text << " (" << 100. * (frameCount - stats.missCount) / frameCount << "% cached)";
+
+        ImGui::TextUnformatted(text.c_str());
+      }
+
+      ImGui::Separator();
+
+      // Camera tiles with the augmented scene, without this window
+      if (!recorder)
+      {
+        if (ImGui::Button("Start recording"))
+        {
+          try
+          {
+            recorder = std::make_unique<FrameRecorder>(recordingFilepath, width_, height_);
+          }
+          catch (const std::exception& e)
+          {
+            std::cerr << e.what() << std::endl;
+          }
+        }
+      }
+      else
+      {
+        if (ImGui::Button("Stop recording"))
+          recorder = nullptr;
+        else
+        {
+          const auto stats = recorder->stats();
+
+          ImGui::Text("Recording: %llu frames, %llu dropped",
+            static_cast<unsigned long long>(stats.capturedCount), static_cast<unsigned long long>(stats.droppedCount));
+        }
+      }
     }
-    
-    if (vcap)
+
+    frameAllocations.EndStage(FrameStage::UI);
+    frameTimes.EndStage(FrameStage::UI);
+
+    for (int streamIndex = 0; streamIndex < streams.size(); streamIndex++)
     {
-      auto image = vcap->Image();
+      auto& stream = *streams[streamIndex];
+
+      std::chrono::high_resolution_clock::time_point captureTime;
+      auto image = stream.capture->Image(captureTime);
 
       if (!image.empty())
       {
-        // Resize if window size is different
-        if (width_ != image.cols || height_ != image.rows)
+        // Calibration takes frames of the first camera on this thread, and the others keep detecting
+        if (appMode_ != AppMode::CALIBRATION || streamIndex != 0)
         {
-          width_ = image.cols;
-          height_ = image.rows;
-          glfwSetWindowSize(window_, width_, height_);
+          scheduler.Submit(stream.detectionStream, image, captureTime);
+          continue;
         }
 
-        cameraTexture.UpdateStorage(image.cols, image.rows);
-
         switch (appMode_)
         {
         case AppMode::CALIBRATION:
@@ -394,29 +1016,33 @@ void Application::Run()
           {
             calibrationCaptureTime = currentTime;
 
+            // Markers are drawn into the Y plane of I420 frames
+            auto calibrationImage = util::DetectionImage(image);
+
             // Detect aruco markers
-            std::vector<std::vector<cv::Point2f>> corners, rejected;
-            std::vector<int> ids;
-            cv::aruco::detectMarkers(image, dictionary, corners, ids, parameters, rejected);
+            detector.Detect(calibrationImage, detection, false);
+            const auto& corners = detection.corners;
+            const auto& ids = detection.ids;
 
             // Interpolate charuco corners
             if (!ids.empty())
             {
               cv::Mat currentCharucoCorners, currentCharucoIds;
-              cv::aruco::interpolateCornersCharuco(corners, ids, image, charucoBoard_,
+              cv::aruco::interpolateCornersCharuco(corners, ids, calibrationImage, charucoBoard_,
                 currentCharucoCorners, currentCharucoIds);
 
-              calibrationImages.push_back(image.clone());
+              calibrationImages.push_back(calibrationImage.clone());
               calibrationCorners.push_back(corners);
               calibrationIds.push_back(ids);
 
               // Draw detected markers
-              cv::aruco::drawDetectedMarkers(image, corners);
-              cv::aruco::drawDetectedCornersCharuco(image, currentCharucoCorners, currentCharucoIds);
+              cv::aruco::drawDetectedMarkers(calibrationImage, corners);
+              cv::aruco::drawDetectedCornersCharuco(calibrationImage, currentCharucoCorners, currentCharucoIds);
             }
 
             // Move to GL texture
-            cameraTexture.Update(image.ptr(), GL_BGR);
+            UploadFrame(stream.texture, image);
+            damaged = true;
 
             // Calibrate if sufficient calibration images are collected
             if (calibrationImages.size() >= requiredCalibrationImages)
@@ -475,6 +1101,7 @@ void Application::Run()
 
               // Save to calib file
               SaveCalibration(cameraMatrix, distortion);
+              scheduler.SetCameraParameters(cameraMatrix, distortion);
 
               appMode_ = AppMode::DETECTION;
 
@@ -487,129 +1114,176 @@ void Application::Run()
         }
         break;
 
-        case AppMode::DETECTION:
-        {
-          // ArUco image detection
-          std::vector<int> markerIds;
-          std::vector<std::vector<cv::Point2f>> markerCorners, rejectedCandidates;
-          cv::aruco::detectMarkers(image, dictionary, markerCorners, markerIds, parameters, rejectedCandidates);
+        default:
+          break;
+        }
+      }
+    }
+
+    frameAllocations.EndStage(FrameStage::FRAMES);
+    frameTimes.EndStage(FrameStage::FRAMES);
 
-          // Draw to image
-          cv::aruco::drawDetectedMarkers(image, markerCorners, markerIds);
+    // Detection results, uploaded together with the frame they belong to
+    for (auto& stream : streams)
+    {
+      auto& result = stream->result;
+      if (!scheduler.TakeResult(stream->detectionStream, result))
+        continue;
 
-          // ArUco pose estimationion
-          std::vector<cv::Vec3d> rvecs, tvecs;
-          cv::aruco::estimatePoseSingleMarkers(markerCorners, markerSize, cameraMatrix, distortion,
-            rvecs, tvecs);
+      auto& image = result.image;
 
-          // Draw axis
-          for (int i = 0; i < rvecs.size(); i++)
-            cv::aruco::drawAxis(image, cameraMatrix, distortion, rvecs[i], tvecs[i], markerSize / 2.f);
+      // Before markers are drawn into the frame
+      if (publisher)
+        PublishResult(*publisher, stream->detectionStream, result);
 
-          // Move to GL texture
-          cameraTexture.Update(image.ptr(), GL_BGR);
-        }
-        break;
+      if (telemetryLog)
+        LogResult(*telemetryLog, frameCount, stream->detectionStream, result, std::chrono::high_resolution_clock::now());
 
-        case AppMode::AUGMENT:
-        {
-          // ArUco image detection
-          std::vector<int> markerIds;
-          std::vector<std::vector<cv::Point2f>> markerCorners, rejectedCandidates;
-          cv::aruco::detectMarkers(image, dictionary, markerCorners, markerIds, parameters, rejectedCandidates);
-
-          // ArUco pose estimationion
-          std::vector<cv::Vec3d> rvecs, tvecs;
-          cv::aruco::estimatePoseSingleMarkers(markerCorners, markerSize, cameraMatrix, distortion,
-            rvecs, tvecs);
-
-          // Store scene model matrix
-          if (tvecs.size() >= 1)
-          {
-            cv::Mat rot;
-            cv::Rodrigues(rvecs[0], rot);
+      switch (appMode_)
+      {
+      case AppMode::DETECTION:
+      {
+        // Draw markers and axis to image, the Y plane of I420 frames
+        auto detectionImage = util::DetectionImage(image);
+        detector.DrawDetection(detectionImage, result.detection);
+      }
+      break;
 
-            for (int r = 0; r < 3; r++)
-            {
-              for (int c = 0; c < 3; c++)
-                model[c][r] = rot.at<double>(r, c) * (markerSize / 2.f);
-              model[3][r] = tvecs[0](r);
-            }
-            model[3][3] = 1.f;
-          }
+      case AppMode::AUGMENT:
+        // Store scene model matrix
+        if (result.detection.tvecs.size() >= 1)
+          stream->model = detector.ModelMatrix(result.detection.rvecs[0], result.detection.tvecs[0]);
+        break;
 
-          // Move to GL texture
-          cameraTexture.Update(image.ptr(), GL_BGR);
-        }
+      default:
         break;
-        }
       }
+
+      // Move to GL texture, a new frame and possibly a new pose
+      UploadFrame(stream->texture, image);
+      damaged = true;
+
+      // The frame goes back to its pool once uploaded
+      image = cv::Mat();
     }
 
+    frameAllocations.EndStage(FrameStage::RESULTS);
+    frameTimes.EndStage(FrameStage::RESULTS);
+
     ImGui::End();
 
-    // Draw camera image
-    glViewport(0, 0, width_, height_);
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    // Tile layout, sized after the first camera image
+    const auto tileColumns = std::max(1, static_cast<int>(std::ceil(std::sqrt(static_cast<double>(streams.size())))));
+    const auto tileRows = std::max(1, static_cast<int>((streams.size() + tileColumns - 1) / tileColumns));
+    uint32_t tileWidth = width_ / tileColumns;
+    uint32_t tileHeight = height_ / tileRows;
+    if (!streams.empty() && streams[0]->texture.Valid())
+    {
+      tileWidth = streams[0]->texture.Width();
+      tileHeight = streams[0]->texture.Height();
+
+      // Resize if window size is different
+      if (width_ != tileColumns * tileWidth || height_ != tileRows * tileHeight)
+      {
+        width_ = tileColumns * tileWidth;
+        height_ = tileRows * tileHeight;
+        glfwSetWindowSize(window_, width_, height_);
+        damaged = true;
+      }
+    }
 
-    if (cameraTexture.Valid())
+    // Fractal animation runs while augmented cameras are shown, and the text cursor blinks while typing
+    const auto animating = appMode_ == AppMode::AUGMENT &&
+      std::any_of(streams.begin(), streams.end(), [](const auto& stream) { return stream->texture.Valid(); });
+    if (animating || ImGui::GetIO().WantTextInput)
+      damaged = true;
+
+    using namespace std::chrono_literals;
+
+    if (!damaged)
     {
-      cameraShader.Use();
+      // Nothing is swapped, so the window keeps showing the last drawn frame
+      ImGui::EndFrame();
 
-      cameraTexture.Bind(0);
-      cameraShader.Uniform1i("tex", 0);
+      frameAllocations.EndStage(FrameStage::RENDER);
+      frameTimes.EndStage(FrameStage::RENDER);
+      frameAllocations.EndFrame(scheduler.Allocations());
 
-      // Don't write depth mask
-      // TODO: plane depth in shader instead of not writing to depth buffer
-      glDepthMask(GL_FALSE);
-      rectGeometry.Draw();
-      glDepthMask(GL_TRUE);
+      if (telemetryLog)
+        frameTimes.Log(*telemetryLog, frameCount, true, streams.size());
 
-      if (appMode_ == AppMode::AUGMENT)
-      {
-        glm::mat3 intrinsic;
-        for (int r = 0; r < 3; r++)
-        {
-          for (int c = 0; c < 3; c++)
-            intrinsic[c][r] = cameraMatrix.at<double>(r, c);
-        }
-        auto screen = glm::vec4(width_, height_, near, far);
+      skippedFrameCount++;
+      frameCount++;
 
-        // Draw axis
-        colorShader.Use();
-        colorShader.UniformMatrix4f("model", model);
-        colorShader.UniformMatrix3f("intrinsic", intrinsic);
-        colorShader.Uniform4f("screen", screen);
+      std::this_thread::sleep_for(1s / 120.f);
+      continue;
+    }
 
-        axisGeometry.Draw();
+    // Draw camera images
+    glViewport(0, 0, width_, height_);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-        // Update fractal animation
-        const auto animationTime = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - animationStartTime).count();
-        fractalGeometry.UpdateAnimation(animationTime);
+    if (appMode_ == AppMode::AUGMENT)
+    {
+      // Update fractal animation
+      const auto animationTime = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - animationStartTime).count();
+      renderer.UpdateAnimation(animationTime);
+    }
 
-        // Draw fractal
-        phongShader.Use();
-        phongShader.UniformMatrix4f("model", model);
-        phongShader.UniformMatrix3f("intrinsic", intrinsic);
-        phongShader.Uniform4f("screen", screen);
+    for (int i = 0; i < streams.size(); i++)
+    {
+      auto& stream = *streams[i];
+      if (!stream.texture.Valid())
+        continue;
 
-        fractalGeometry.Draw();
-      }
+      const auto column = i % tileColumns;
+      const auto row = i / tileColumns;
+      glViewport(column * tileWidth, (tileRows - 1 - row) * tileHeight, tileWidth, tileHeight);
+
+      renderer.DrawCamera(stream.texture);
+
+      if (appMode_ == AppMode::AUGMENT)
+        renderer.DrawAugment(stream.model, detector.Intrinsic(), stream.texture.Width(), stream.texture.Height());
+    }
+
+    glViewport(0, 0, width_, height_);
+
+    // The video keeps the size it started with
+    if (recorder && (recorder->Width() != width_ || recorder->Height() != height_))
+    {
+      std::cout << "Window resized, recording stopped" << std::endl;
+      recorder = nullptr;
     }
 
+    if (recorder)
+      recorder->Capture();
+
     // Render dear imgui into screen
     ImGui::Render();
     ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
 
     glfwSwapBuffers(window_);
 
+    frameAllocations.EndStage(FrameStage::RENDER);
+    frameTimes.EndStage(FrameStage::RENDER);
+    frameAllocations.EndFrame(scheduler.Allocations());
+
+    if (telemetryLog)
+      frameTimes.Log(*telemetryLog, frameCount, false, streams.size());
+
+    drawTime = currentTime;
+    if (inputFrames_ > 0)
+      inputFrames_--;
+
     frameCount++;
 
     // Delay between thread
-    using namespace std::chrono_literals;
     std::this_thread::sleep_for(1s / 120.f);
   }
 
+  // Finish the recording while the GL context is alive
+  recorder = nullptr;
+
   // TODO: destroy contexts in destructor?
   glfwDestroyWindow(window_);
 
@@ -617,4 +1291,48 @@ void Application::Run()
   ImGui_ImplGlfw_Shutdown();
   ImGui::DestroyContext();
 }
+
+void Application::RunBatch(const std::string& inputFilepath, const std::string& outputFilepath, const std::vector<int>& workerCounts)
+{
+  // Rendering goes to an offscreen framebuffer
+  glfwHideWindow(window_);
+
+  // Batch frames are decoded into the same few sizes over and over
+  util::PooledMatAllocator::InstallDefault();
+
+  scene::Fractal::CreateInfo fractalCreateInfo;
+  fractalCreateInfo.maxTriangleCount = fractalMaxTriangleCount;
+  Renderer renderer(shaderDirpath, scene::Fractal::LoadOrCreate(fractalCacheFilepath, fractalCreateInfo, fractalSeed));
+
+  cv::Mat cameraMatrix;
+  cv::Mat distortion;
+  LoadCalibration(cameraMatrix, distortion);
+
+  vision::MarkerDetector detector(markerSize);
+  if (detector.LoadParameters(detectorParametersFilepath))
+    std::cout << "Detector parameters loaded from " << detectorParametersFilepath << std::endl;
+  detector.SetCameraParameters(cameraMatrix, distortion);
+
+  BatchProcessor processor(detector, renderer);
+
+  std::vector<BatchProcessor::Result> results;
+  for (auto workerCount : workerCounts)
+  {
+    const auto result = processor.Process(inputFilepath, outputFilepath, workerCount);
+    results.push_back(result);
+
+    std::cout << "Processed " << result.frameCount << " frames with " << result.workerCount << " workers: "
+      << result.seconds << "s, " << result.Fps() << " fps" << std::endl;
+  }
+
+  std::cout << "workers, fps" << std::endl;
+  for (const auto& result : results)
+    std::cout << result.workerCount << ", " << result.Fps() << std::endl;
+
+  glfwDestroyWindow(window_);
+
+  ImGui_ImplOpenGL3_Shutdown();
+  ImGui_ImplGlfw_Shutdown();
+  ImGui::DestroyContext();
+}
 }
@@ -0,0 +1,173 @@
+#include <glar/batch_processor.h>
+
+#include <stdexcept>
+#include <iostream>
+#include <chrono>
+#include <map>
+#include <string>
+#include <mutex>
+#include <condition_variable>
+
+#include <glad/glad.h>
+
+#include <opencv2/core.hpp>
+#include <opencv2/videoio.hpp>
+
+#include <glar/renderer.h>
+#include <glar/gl/framebuffer.h>
+#include <glar/gl/texture.h>
+#include <glar/util/thread_pool.h>
+#include <glar/vision/marker_detector.h>
+
+namespace glar
+{
+namespace
+{
+struct FrameResult
+{
+  cv::Mat image;
+  vision::MarkerDetection detection;
+
+  // Set if detection threw, so that the frame still arrives in order
+  std::string error;
+};
+}
+
+BatchProcessor::BatchProcessor(const vision::MarkerDetector& detector, Renderer& renderer)
+  : detector_(detector)
+  , renderer_(renderer)
+{
+}
+
+BatchProcessor::~BatchProcessor() = default;
+
+BatchProcessor::Result BatchProcessor::Process(const std::string& inputFilepath, const std::string& outputFilepath, int workerCount)
+{
+  cv::VideoCapture input(inputFilepath);
+  if (!input.isOpened())
+    throw std::runtime_error("Failed to open video file: " + inputFilepath);
+
+  const auto width = static_cast<uint32_t>(input.get(cv::CAP_PROP_FRAME_WIDTH));
+  const auto height = static_cast<uint32_t>(input.get(cv::CAP_PROP_FRAME_HEIGHT));
+  auto fps = input.get(cv::CAP_PROP_FPS);
+  if (fps <= 0.)
+    fps = 30.;
+
+  cv::VideoWriter output(outputFilepath, cv::VideoWriter::fourcc('m', 'p', '4', 'v'), fps, cv::Size(width, height));
+  if (!output.isOpened())
+    throw std::runtime_error("Failed to open video file for writing: " + outputFilepath);
+
+  gl::Framebuffer framebuffer(width, height);
+  gl::Texture cameraTexture(width, height);
+  const auto intrinsic = detector_.Intrinsic();
+
+  // Declared before the pool, which joins its workers first when destroyed
+  std::map<uint64_t, FrameResult> results;
+  std::mutex resultMutex;
+  std::condition_variable resultCondition;
+
+  util::ThreadPool pool(workerCount);
+
+  // Bound the number of decoded frames waiting for workers or for reordering
+  const uint64_t maxFramesInFlight = 2 * pool.WorkerCount();
+
+  uint64_t readIndex = 0;
+  uint64_t writeIndex = 0;
+  bool endOfStream = false;
+
+  glm::mat4 model(1.f);
+  bool hasPose = false;
+  cv::Mat composited(height, width, CV_8UC3);
+
+  const auto startTime = std::chrono::high_resolution_clock::now();
+  while (true)
+  {
+    // Keep workers busy
+    while (!endOfStream && readIndex - writeIndex < maxFramesInFlight)
+    {
+      cv::Mat image;
+      if (!input.read(image))
+      {
+        endOfStream = true;
+        break;
+      }
+
+      const auto frameIndex = readIndex++;
+      pool.Enqueue([this, frameIndex, image, &results, &resultMutex, &resultCondition]
+        {
+          FrameResult result;
+          result.image = image;
+          try
+          {
+            detector_.Detect(image, result.detection);
+          }
+          catch (const std::exception& e)
+          {
+            result.error = e.what();
+          }
+
+          {
+            std::unique_lock<std::mutex> guard(resultMutex);
+            results.emplace(frameIndex, std::move(result));
+          }
+          resultCondition.notify_one();
+        });
+    }
+
+    if (writeIndex == readIndex)
+      break;
+
+    // Next frame in order
+    FrameResult result;
+    {
+      std::unique_lock<std::mutex> guard(resultMutex);
+      resultCondition.wait(guard, [&] { return results.count(writeIndex) > 0; });
+
+      auto it = results.find(writeIndex);
+      result = std::move(it->second);
+      results.erase(it);
+    }
+
+    // Frames in flight are finished by the pool before it is destroyed
+    if (!result.error.empty())
+      throw std::runtime_error("Failed to detect markers in frame " + std::to_string(writeIndex) + ": " + result.error);
+
+    if (!result.detection.tvecs.empty())
+    {
+      model = detector_.ModelMatrix(result.detection.rvecs[0], result.detection.tvecs[0]);
+      hasPose = true;
+    }
+
+    // Composite
+    cameraTexture.Update(result.image.ptr(), GL_BGR);
+
+    framebuffer.Bind();
+    glViewport(0, 0, width, height);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+    renderer_.DrawCamera(cameraTexture);
+
+    if (hasPose)
+    {
+      const auto animationTime = static_cast<float>(writeIndex / fps);
+      renderer_.UpdateAnimation(animationTime);
+      renderer_.DrawAugment(model, intrinsic, width, height);
+    }
+
+    gl::Framebuffer::BindDefault();
+
+    framebuffer.ReadPixels(composited.ptr(), GL_BGR);
+    cv::flip(composited, composited, 0);
+    output.write(composited);
+
+    writeIndex++;
+  }
+  const auto endTime = std::chrono::high_resolution_clock::now();
+
+  Result result;
+  result.workerCount = pool.WorkerCount();
+  result.frameCount = writeIndex;
+  result.seconds = std::chrono::duration<double>(endTime - startTime).count();
+  return result;
+}
+}
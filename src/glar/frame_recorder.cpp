@@ -0,0 +1,173 @@
+#include <glar/frame_recorder.h>
+
+#include <iostream>
+#include <stdexcept>
+
+#include <opencv2/core.hpp>
+
+namespace glar
+{
+namespace
+{
+constexpr int readbackBufferCount = 3;
+constexpr size_t maxQueuedFrames = 8;
+
+uint64_t Slot(std::chrono::high_resolution_clock::time_point time, std::chrono::high_resolution_clock::time_point startTime, double fps)
+{
+  return static_cast<uint64_t>(std::chrono::duration<double>(time - startTime).count() * fps);
+}
+}
+
+FrameRecorder::FrameRecorder(const std::string& filepath, uint32_t width, uint32_t height, double fps)
+  : filepath_(filepath)
+  , fps_(fps)
+  , readback_(width, height, readbackBufferCount)
+  , pool_(readbackBufferCount + maxQueuedFrames + 1)
+  , startTime_(std::chrono::high_resolution_clock::now())
+{
+  writer_.open(filepath, cv::VideoWriter::fourcc('m', 'p', '4', 'v'), fps, cv::Size(width, height));
+  if (!writer_.isOpened())
+    throw std::runtime_error("Failed to open video file for writing: " + filepath);
+
+  encoder_ = std::thread([this] { Encode(); });
+
+  std::cout << "Recording to " << filepath << std::endl;
+}
+
+FrameRecorder::~FrameRecorder()
+{
+  // Readbacks in flight are still recorded
+  Collect(true);
+
+  {
+    std::unique_lock<std::mutex> guard(queueMutex_);
+    finished_ = true;
+    stopTime_ = std::chrono::high_resolution_clock::now();
+  }
+  queueCondition_.notify_one();
+
+  encoder_.join();
+  writer_.release();
+
+  const auto stats = this->stats();
+  std::cout << "Recorded " << stats.capturedCount << " frames to " << filepath_ << ", "
+    << stats.writtenCount << " written, " << stats.droppedCount << " dropped" << std::endl;
+}
+
+void FrameRecorder::Capture()
+{
+  Collect(false);
+
+  // At most one capture per frame of the video
+  const auto currentTime = std::chrono::high_resolution_clock::now();
+  const auto slot = Slot(currentTime, startTime_, fps_);
+  if (slot < captureSlot_)
+    return;
+  captureSlot_ = slot + 1;
+
+  if (!readback_.Read())
+  {
+    std::unique_lock<std::mutex> guard(statsMutex_);
+    stats_.droppedCount++;
+    return;
+  }
+
+  readbackTimes_.push_back(currentTime);
+}
+
+FrameRecorder::Stats FrameRecorder::stats() const
+{
+  std::unique_lock<std::mutex> guard(statsMutex_);
+  return stats_;
+}
+
+void FrameRecorder::Collect(bool wait)
+{
+  while (readback_.PendingCount() > 0)
+  {
+    auto image = pool_.Acquire(Height(), Width(), CV_8UC3);
+
+    const auto pendingCount = readback_.PendingCount();
+    const auto taken = readback_.Take(image.data, wait);
+    if (readback_.PendingCount() == pendingCount)
+      break;
+
+    Frame frame;
+    frame.image = image;
+    frame.captureTime = readbackTimes_.front();
+    readbackTimes_.pop_front();
+
+    bool queued = false;
+    if (taken)
+    {
+      std::unique_lock<std::mutex> guard(queueMutex_);
+      if (queue_.size() < maxQueuedFrames)
+      {
+        queue_.push_back(std::move(frame));
+        queued = true;
+      }
+    }
+
+    if (queued)
+      queueCondition_.notify_one();
+
+    std::unique_lock<std::mutex> guard(statsMutex_);
+    if (queued)
+      stats_.capturedCount++;
+    else
+      stats_.droppedCount++;
+  }
+}
+
+void FrameRecorder::Encode()
+{
+  cv::Mat flipped;
+  cv::Mat previous;
+  uint64_t nextSlot = 0;
+
+  while (true)
+  {
+    Frame frame;
+    {
+      std::unique_lock<std::mutex> guard(queueMutex_);
+      queueCondition_.wait(guard, [this] { return !queue_.empty() || finished_; });
+      if (queue_.empty())
+        break;
+
+      frame = std::move(queue_.front());
+      queue_.pop_front();
+    }
+
+    // Bottom row first from GL
+    cv::flip(frame.image, flipped, 0);
+    frame.image.release();
+
+    // Nothing was redrawn in the slots without a frame
+    const auto slot = Slot(frame.captureTime, startTime_, fps_);
+    uint64_t writtenCount = 0;
+    for (; !previous.empty() && nextSlot < slot; nextSlot++, writtenCount++)
+      writer_.write(previous);
+
+    if (nextSlot <= slot)
+    {
+      writer_.write(flipped);
+      nextSlot = slot + 1;
+      writtenCount++;
+    }
+
+    std::swap(previous, flipped);
+
+    std::unique_lock<std::mutex> guard(statsMutex_);
+    stats_.writtenCount += writtenCount;
+  }
+
+  // Still frame until the recording stopped
+  const auto stopSlot = Slot(stopTime_, startTime_, fps_);
+  uint64_t writtenCount = 0;
+  for (; !previous.empty() && nextSlot < stopSlot; nextSlot++, writtenCount++)
+    writer_.write(previous);
+
+  std::unique_lock<std::mutex> guard(statsMutex_);
+  stats_.writtenCount += writtenCount;
+}
+}
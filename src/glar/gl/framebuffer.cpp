@@ -0,0 +1,115 @@
+#include <glar/gl/framebuffer.h>
+
+#include <stdexcept>
+
+namespace glar
+{
+namespace gl
+{
+Framebuffer::Framebuffer(uint32_t width, uint32_t height)
+  : width_(width), height_(height)
+{
+  glGenFramebuffers(1, &framebuffer_);
+  CreateAttachments();
+}
+
+Framebuffer::~Framebuffer()
+{
+  DestroyAttachments();
+  glDeleteFramebuffers(1, &framebuffer_);
+}
+
+void Framebuffer::Resize(uint32_t width, uint32_t height)
+{
+  if (width_ != width || height_ != height)
+  {
+    width_ = width;
+    height_ = height;
+
+    DestroyAttachments();
+    CreateAttachments();
+  }
+}
+
+void Framebuffer::Bind()
+{
+  glBindFramebuffer(GL_FRAMEBUFFER, framebuffer_);
+}
+
+void Framebuffer::BindDefault()
+{
+  glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void Framebuffer::Clear()
+{
+  constexpr GLfloat transparent[] = { 0.f, 0.f, 0.f, 0.f };
+  constexpr GLfloat depth = 1.f;
+
+  glBindFramebuffer(GL_DRAW_FRAMEBUFFER, framebuffer_);
+  glClearBufferfv(GL_COLOR, 0, transparent);
+  glClearBufferfv(GL_DEPTH, 0, &depth);
+}
+
+void Framebuffer::BindColorTexture(int index)
+{
+  glActiveTexture(GL_TEXTURE0 + index);
+  glBindTexture(GL_TEXTURE_2D, colorTexture_);
+}
+
+void Framebuffer::BindDepthTexture(int index)
+{
+  glActiveTexture(GL_TEXTURE0 + index);
+  glBindTexture(GL_TEXTURE_2D, depthTexture_);
+}
+
+void Framebuffer::ReadPixels(void* pixels, GLenum format)
+{
+  glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer_);
+  glPixelStorei(GL_PACK_ALIGNMENT, 1);
+  glReadPixels(0, 0, width_, height_, format, GL_UNSIGNED_BYTE, pixels);
+  glPixelStorei(GL_PACK_ALIGNMENT, 4);
+  glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+}
+
+void Framebuffer::CreateAttachments()
+{
+  glGenTextures(1, &colorTexture_);
+  glBindTexture(GL_TEXTURE_2D, colorTexture_);
+  glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA8, width_, height_);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+  glBindTexture(GL_TEXTURE_2D, 0);
+
+  // Sampled for depth-aware upsampling, so not filtered
+  glGenTextures(1, &depthTexture_);
+  glBindTexture(GL_TEXTURE_2D, depthTexture_);
+  glTexStorage2D(GL_TEXTURE_2D, 1, GL_DEPTH_COMPONENT24, width_, height_);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+  glBindTexture(GL_TEXTURE_2D, 0);
+
+  glBindFramebuffer(GL_FRAMEBUFFER, framebuffer_);
+  glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, colorTexture_, 0);
+  glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, depthTexture_, 0);
+
+  const auto status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+  glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+  if (status != GL_FRAMEBUFFER_COMPLETE)
+    throw std::runtime_error("Incomplete framebuffer");
+}
+
+void Framebuffer::DestroyAttachments()
+{
+  glDeleteTextures(1, &depthTexture_);
+  glDeleteTextures(1, &colorTexture_);
+  depthTexture_ = 0;
+  colorTexture_ = 0;
+}
+}
+}
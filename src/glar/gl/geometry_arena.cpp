@@ -0,0 +1,248 @@
+#include <glar/gl/geometry_arena.h>
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace glar
+{
+namespace gl
+{
+namespace
+{
+// All attributes are read from one buffer binding
+constexpr GLuint bindingIndex = 0;
+}
+
+GeometryArena::RangeAllocator::RangeAllocator(uint32_t capacity)
+  : capacity_(capacity)
+{
+  if (capacity > 0)
+    free_.emplace(0, capacity);
+}
+
+bool GeometryArena::RangeAllocator::Allocate(uint32_t size, uint32_t& offset)
+{
+  if (size == 0)
+  {
+    offset = 0;
+    return true;
+  }
+
+  for (auto it = free_.begin(); it != free_.end(); ++it)
+  {
+    if (it->second >= size)
+    {
+      offset = it->first;
+      const auto rest = it->second - size;
+      free_.erase(it);
+      if (rest > 0)
+        free_.emplace(offset + size, rest);
+      return true;
+    }
+  }
+  return false;
+}
+
+void GeometryArena::RangeAllocator::Free(uint32_t offset, uint32_t size)
+{
+  if (size == 0)
+    return;
+
+  auto it = free_.emplace(offset, size).first;
+
+  // Merge with the next and the previous free range
+  auto next = std::next(it);
+  if (next != free_.end() && it->first + it->second == next->first)
+  {
+    it->second += next->second;
+    free_.erase(next);
+  }
+
+  if (it != free_.begin())
+  {
+    auto previous = std::prev(it);
+    if (previous->first + previous->second == it->first)
+    {
+      previous->second += it->second;
+      free_.erase(it);
+    }
+  }
+}
+
+void GeometryArena::RangeAllocator::Grow(uint32_t capacity)
+{
+  const auto oldCapacity = capacity_;
+  capacity_ = capacity;
+  Free(oldCapacity, capacity - oldCapacity);
+}
+
+GeometryArena::GeometryArena(std::initializer_list<Attribute> attributes, uint32_t vertexCapacity, uint32_t indexCapacity)
+  : vertexRanges_(vertexCapacity)
+  , indexRanges_(indexCapacity)
+{
+  for (const auto& attribute : attributes)
+  {
+    const auto stride = static_cast<uint32_t>(attribute.stride > 0 ? attribute.stride : attribute.size);
+    if (vertexSize_ != 0 && vertexSize_ != stride)
+      throw std::runtime_error("Geometry arena attributes must be interleaved with the same stride");
+    vertexSize_ = stride;
+  }
+
+  if (vertexSize_ == 0)
+    throw std::runtime_error("Geometry arena needs at least one attribute");
+
+  vertexBuffer_ = CreateBuffer(static_cast<size_t>(vertexCapacity) * vertexSize_ * sizeof(float));
+  indexBuffer_ = CreateBuffer(static_cast<size_t>(indexCapacity) * sizeof(uint32_t));
+
+  // Separate attribute format, so that a reallocated buffer is attached without redefining the attributes
+  glGenVertexArrays(1, &vao_);
+  glBindVertexArray(vao_);
+
+  for (const auto& attribute : attributes)
+  {
+    glVertexAttribFormat(attribute.index, attribute.size, GL_FLOAT, GL_FALSE, attribute.offset * sizeof(float));
+    glVertexAttribBinding(attribute.index, bindingIndex);
+    glEnableVertexAttribArray(attribute.index);
+  }
+
+  glBindVertexBuffer(bindingIndex, vertexBuffer_, 0, vertexSize_ * sizeof(float));
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer_);
+
+  glBindVertexArray(0);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+}
+
+GeometryArena::~GeometryArena()
+{
+  glDeleteVertexArrays(1, &vao_);
+  glDeleteBuffers(1, &vertexBuffer_);
+  glDeleteBuffers(1, &indexBuffer_);
+}
+
+GeometryArena::Range GeometryArena::Allocate(const std::vector<float>& vertexBuffer, const std::vector<uint32_t>& indexBuffer, GLenum drawMode)
+{
+  if (vertexBuffer.size() % vertexSize_ != 0)
+    throw std::runtime_error("Vertex buffer is not a whole number of vertices");
+
+  Range range;
+  range.drawMode = drawMode;
+  range.vertexCount = static_cast<uint32_t>(vertexBuffer.size() / vertexSize_);
+  range.indexCount = static_cast<uint32_t>(indexBuffer.size());
+
+  if (!vertexRanges_.Allocate(range.vertexCount, range.baseVertex))
+  {
+    GrowVertexBuffer(std::max(vertexCapacity() * 2, vertexCapacity() + range.vertexCount));
+    vertexRanges_.Allocate(range.vertexCount, range.baseVertex);
+  }
+
+  if (!indexRanges_.Allocate(range.indexCount, range.firstIndex))
+  {
+    GrowIndexBuffer(std::max(indexCapacity() * 2, indexCapacity() + range.indexCount));
+    indexRanges_.Allocate(range.indexCount, range.firstIndex);
+  }
+
+  // Copy write target, so that the element buffer binding of whatever vertex array is bound stays as it is
+  glBindBuffer(GL_COPY_WRITE_BUFFER, vertexBuffer_);
+  glBufferSubData(GL_COPY_WRITE_BUFFER, static_cast<GLintptr>(range.baseVertex) * vertexSize_ * sizeof(float),
+    vertexBuffer.size() * sizeof(float), vertexBuffer.data());
+
+  glBindBuffer(GL_COPY_WRITE_BUFFER, indexBuffer_);
+  glBufferSubData(GL_COPY_WRITE_BUFFER, static_cast<GLintptr>(range.firstIndex) * sizeof(uint32_t),
+    indexBuffer.size() * sizeof(uint32_t), indexBuffer.data());
+  glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+  return range;
+}
+
+void GeometryArena::Free(const Range& range)
+{
+  vertexRanges_.Free(range.baseVertex, range.vertexCount);
+  indexRanges_.Free(range.firstIndex, range.indexCount);
+}
+
+void GeometryArena::Bind()
+{
+  glBindVertexArray(vao_);
+}
+
+void GeometryArena::Draw(const Range& range)
+{
+  glDrawElementsBaseVertex(range.drawMode, range.indexCount, GL_UNSIGNED_INT,
+    (void*)(static_cast<size_t>(range.firstIndex) * sizeof(uint32_t)), range.baseVertex);
+}
+
+void GeometryArena::Draw(const std::vector<Range>& ranges)
+{
+  for (size_t begin = 0; begin < ranges.size();)
+  {
+    const auto drawMode = ranges[begin].drawMode;
+
+    drawCounts_.clear();
+    drawOffsets_.clear();
+    drawBaseVertices_.clear();
+
+    auto end = begin;
+    for (; end < ranges.size() && ranges[end].drawMode == drawMode; end++)
+    {
+      drawCounts_.push_back(ranges[end].indexCount);
+      drawOffsets_.push_back((const void*)(static_cast<size_t>(ranges[end].firstIndex) * sizeof(uint32_t)));
+      drawBaseVertices_.push_back(ranges[end].baseVertex);
+    }
+
+    glMultiDrawElementsBaseVertex(drawMode, drawCounts_.data(), GL_UNSIGNED_INT, drawOffsets_.data(),
+      static_cast<GLsizei>(drawCounts_.size()), drawBaseVertices_.data());
+
+    begin = end;
+  }
+}
+
+GLuint GeometryArena::CreateBuffer(size_t size)
+{
+  GLuint buffer;
+  glGenBuffers(1, &buffer);
+  glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+  glBufferData(GL_COPY_WRITE_BUFFER, size, NULL, GL_STATIC_DRAW);
+  glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+  return buffer;
+}
+
+void GeometryArena::GrowVertexBuffer(uint32_t capacity)
+{
+  const auto vertexBytes = vertexSize_ * sizeof(float);
+  const auto buffer = CreateBuffer(capacity * vertexBytes);
+
+  glBindBuffer(GL_COPY_READ_BUFFER, vertexBuffer_);
+  glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+  glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, vertexCapacity() * vertexBytes);
+  glBindBuffer(GL_COPY_READ_BUFFER, 0);
+  glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+  glDeleteBuffers(1, &vertexBuffer_);
+  vertexBuffer_ = buffer;
+  vertexRanges_.Grow(capacity);
+
+  glBindVertexArray(vao_);
+  glBindVertexBuffer(bindingIndex, vertexBuffer_, 0, vertexBytes);
+  glBindVertexArray(0);
+}
+
+void GeometryArena::GrowIndexBuffer(uint32_t capacity)
+{
+  const auto buffer = CreateBuffer(capacity * sizeof(uint32_t));
+
+  glBindBuffer(GL_COPY_READ_BUFFER, indexBuffer_);
+  glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+  glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, indexCapacity() * sizeof(uint32_t));
+  glBindBuffer(GL_COPY_READ_BUFFER, 0);
+  glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+  glDeleteBuffers(1, &indexBuffer_);
+  indexBuffer_ = buffer;
+  indexRanges_.Grow(capacity);
+
+  glBindVertexArray(vao_);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer_);
+  glBindVertexArray(0);
+}
+}
+}
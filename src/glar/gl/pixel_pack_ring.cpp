@@ -0,0 +1,88 @@
+#include <glar/gl/pixel_pack_ring.h>
+
+#include <cstring>
+#include <stdexcept>
+
+namespace glar
+{
+namespace gl
+{
+PixelPackRing::PixelPackRing(uint32_t width, uint32_t height, int bufferCount)
+  : width_(width)
+  , height_(height)
+  , slots_(bufferCount)
+{
+  for (auto& slot : slots_)
+  {
+    glGenBuffers(1, &slot.buffer);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+    glBufferData(GL_PIXEL_PACK_BUFFER, FrameSize(), NULL, GL_STREAM_READ);
+  }
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+}
+
+PixelPackRing::~PixelPackRing()
+{
+  for (auto& slot : slots_)
+  {
+    if (slot.fence)
+      glDeleteSync(slot.fence);
+    glDeleteBuffers(1, &slot.buffer);
+  }
+}
+
+bool PixelPackRing::Read()
+{
+  if (pendingCount_ == static_cast<int>(slots_.size()))
+    return false;
+
+  auto& slot = slots_[next_];
+
+  // Rows of BGR are not 4-byte aligned in general
+  GLint packAlignment;
+  glGetIntegerv(GL_PACK_ALIGNMENT, &packAlignment);
+  glPixelStorei(GL_PACK_ALIGNMENT, 1);
+
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+  glReadPixels(0, 0, width_, height_, GL_BGR, GL_UNSIGNED_BYTE, 0);
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+  glPixelStorei(GL_PACK_ALIGNMENT, packAlignment);
+
+  slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+  next_ = (next_ + 1) % slots_.size();
+  pendingCount_++;
+  return true;
+}
+
+bool PixelPackRing::Take(void* pixels, bool wait)
+{
+  if (pendingCount_ == 0)
+    return false;
+
+  auto& slot = slots_[(next_ + slots_.size() - pendingCount_) % slots_.size()];
+
+  // Flush, so that the fence is eventually signaled without another flush from the caller
+  const GLuint64 timeout = wait ? 1000000000 : 0; // 1s
+  const auto status = glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, timeout);
+  if (status == GL_TIMEOUT_EXPIRED || status == GL_WAIT_FAILED)
+    return false;
+
+  glDeleteSync(slot.fence);
+  slot.fence = nullptr;
+  pendingCount_--;
+
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+  const auto data = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, FrameSize(), GL_MAP_READ_BIT);
+  if (data != nullptr)
+  {
+    std::memcpy(pixels, data, FrameSize());
+    glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+  }
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+  return data != nullptr;
+}
+}
+}
@@ -51,6 +51,29 @@ GLuint LoadShaderModule(const std::string& shaderFilepath, GLenum shaderStage)
 
 Shader::Shader(const std::string& dirpath, const std::string& name)
 {
+  const auto computeShaderFilepath = dirpath + "\\" + name + ".comp";
+  if (FileExists(computeShaderFilepath))
+  {
+    const auto computeShader = LoadShaderModule(computeShaderFilepath, GL_COMPUTE_SHADER);
+
+    program_ = glCreateProgram();
+    glAttachShader(program_, computeShader);
+    glLinkProgram(program_);
+
+    GLint success;
+    GLchar infoLog[1024];
+    glGetProgramiv(program_, GL_LINK_STATUS, &success);
+    if (!success)
+    {
+      glGetProgramInfoLog(program_, 1024, NULL, infoLog);
+      std::cout << "Failed to link compute shader program, error:" << std::endl
+        << infoLog << std::endl;
+    }
+
+    glDeleteShader(computeShader);
+    return;
+  }
+
   const auto vertexShader = LoadShaderModule(dirpath + "\\" + name + ".vert", GL_VERTEX_SHADER);
   const auto fragmentShader = LoadShaderModule(dirpath + "\\" + name + ".frag", GL_FRAGMENT_SHADER);
 
@@ -106,6 +129,11 @@ void Shader::UniformMatrix3f(const std::string& name, const glm::mat3& m)
   glUniformMatrix3fv(glGetUniformLocation(program_, name.c_str()), 1, GL_FALSE, &m[0][0]);
 }
 
+void Shader::Uniform2f(const std::string& name, const glm::vec2& v)
+{
+  glUniform2fv(glGetUniformLocation(program_, name.c_str()), 1, &v[0]);
+}
+
 void Shader::Uniform4f(const std::string& name, const glm::vec4& v)
 {
   glUniform4fv(glGetUniformLocation(program_, name.c_str()), 1, &v[0]);
@@ -115,5 +143,15 @@ void Shader::Uniform1i(const std::string& name, int value)
 {
   glUniform1i(glGetUniformLocation(program_, name.c_str()), value);
 }
+
+void Shader::Uniform1ui(const std::string& name, uint32_t value)
+{
+  glUniform1ui(glGetUniformLocation(program_, name.c_str()), value);
+}
+
+void Shader::Uniform1f(const std::string& name, float value)
+{
+  glUniform1f(glGetUniformLocation(program_, name.c_str()), value);
+}
 }
 }
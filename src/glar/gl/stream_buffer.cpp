@@ -0,0 +1,110 @@
+#include <glar/gl/stream_buffer.h>
+
+#include <stdexcept>
+
+namespace glar
+{
+namespace gl
+{
+StreamBuffer::StreamBuffer(size_t partitionSize, int partitionCount)
+  : partitionSize_(partitionSize)
+  , fences_(partitionCount, nullptr)
+{
+  const auto size = static_cast<GLsizeiptr>(partitionSize * partitionCount);
+
+  // Copy write target doesn't disturb bindings of vertex array objects
+  glGenBuffers(1, &buffer_);
+  glBindBuffer(GL_COPY_WRITE_BUFFER, buffer_);
+
+  if (GLAD_GL_VERSION_4_4)
+  {
+    constexpr GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    glBufferStorage(GL_COPY_WRITE_BUFFER, size, NULL, flags);
+    persistentData_ = static_cast<char*>(glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, size, flags));
+
+    if (persistentData_ == nullptr)
+      throw std::runtime_error("Failed to map stream buffer persistently");
+  }
+  else
+    glBufferData(GL_COPY_WRITE_BUFFER, size, NULL, GL_STREAM_DRAW);
+
+  glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+  // The first Map() moves to partition 0
+  partition_ = partitionCount - 1;
+}
+
+StreamBuffer::~StreamBuffer()
+{
+  for (auto fence : fences_)
+  {
+    if (fence)
+      glDeleteSync(fence);
+  }
+
+  if (persistentData_ || mapped_)
+  {
+    glBindBuffer(GL_COPY_WRITE_BUFFER, buffer_);
+    glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+  }
+
+  glDeleteBuffers(1, &buffer_);
+}
+
+void* StreamBuffer::Map()
+{
+  if (mapped_)
+    Unmap();
+
+  partition_ = (partition_ + 1) % PartitionCount();
+
+  // Normally signaled already, when rendering is not behind by a whole ring
+  auto& fence = fences_[partition_];
+  if (fence)
+  {
+    constexpr GLuint64 timeout = 1000000000; // 1s
+    while (glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, timeout) == GL_TIMEOUT_EXPIRED)
+    {
+    }
+
+    glDeleteSync(fence);
+    fence = nullptr;
+  }
+
+  if (persistentData_)
+    return persistentData_ + PartitionOffset();
+
+  glBindBuffer(GL_COPY_WRITE_BUFFER, buffer_);
+  auto data = glMapBufferRange(GL_COPY_WRITE_BUFFER, PartitionOffset(), partitionSize_,
+    GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+  glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+  mapped_ = true;
+  return data;
+}
+
+void StreamBuffer::Unmap()
+{
+  // Coherent persistent mapping needs no flush
+  if (!mapped_)
+    return;
+
+  glBindBuffer(GL_COPY_WRITE_BUFFER, buffer_);
+  glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+  glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+  mapped_ = false;
+}
+
+void StreamBuffer::Fence()
+{
+  // Only the last draw reading the partition matters
+  auto& fence = fences_[partition_];
+  if (fence)
+    glDeleteSync(fence);
+
+  fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+}
+}
@@ -6,19 +6,35 @@ namespace glar
 {
 namespace gl
 {
+namespace
+{
+GLuint CreateTexture(GLenum internalFormat, uint32_t width, uint32_t height)
+{
+  GLuint texture;
+  glGenTextures(1, &texture);
+  glBindTexture(GL_TEXTURE_2D, texture);
+  glTexStorage2D(GL_TEXTURE_2D, 1, internalFormat, width, height);
+
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+  return texture;
+}
+}
+
 Texture::Texture()
 {
 }
 
-Texture::Texture(uint32_t width, uint32_t height)
+Texture::Texture(uint32_t width, uint32_t height, Format format)
 {
-  UpdateStorage(width, height);
+  UpdateStorage(width, height, format);
 }
 
 Texture::~Texture()
 {
-  if (texture_)
-    glDeleteTextures(1, &texture_);
+  Delete();
 }
 
 bool Texture::Valid() const
@@ -33,28 +49,43 @@ void Texture::Bind()
 
 void Texture::Bind(int index)
 {
-  Bind();
   glActiveTexture(GL_TEXTURE0 + index);
+  Bind();
+
+  if (format_ == Format::I420)
+  {
+    for (int i = 0; i < 2; i++)
+    {
+      glActiveTexture(GL_TEXTURE0 + index + 1 + i);
+      glBindTexture(GL_TEXTURE_2D, chromaTextures_[i]);
+    }
+  }
+
+  glActiveTexture(GL_TEXTURE0);
 }
 
-void Texture::UpdateStorage(uint32_t width, uint32_t height)
+void Texture::UpdateStorage(uint32_t width, uint32_t height, Format format)
 {
-  if (width_ != width || height_ != height)
+  if (width_ != width || height_ != height || format_ != format)
   {
     width_ = width;
     height_ = height;
+    format_ = format;
 
-    if (texture_)
-      glDeleteTextures(1, &texture_);
+    Delete();
 
-    glGenTextures(1, &texture_);
-    glBindTexture(GL_TEXTURE_2D, texture_);
-    glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGB8, width, height);
+    switch (format)
+    {
+    case Format::RGB:
+      texture_ = CreateTexture(GL_RGB8, width, height);
+      break;
 
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    case Format::I420:
+      texture_ = CreateTexture(GL_R8, width, height);
+      for (auto& chromaTexture : chromaTextures_)
+        chromaTexture = CreateTexture(GL_R8, width / 2, height / 2);
+      break;
+    }
   }
 }
 
@@ -63,5 +94,41 @@ void Texture::Update(void* pixels, GLenum format)
   Bind();
   glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width_, height_, format, GL_UNSIGNED_BYTE, pixels);
 }
+
+void Texture::UpdateI420(const void* pixels)
+{
+  // Plane rows are tightly packed, and not necessarily 4 byte aligned
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+  const auto* y = static_cast<const uint8_t*>(pixels);
+  Bind();
+  glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width_, height_, GL_RED, GL_UNSIGNED_BYTE, y);
+
+  const auto chromaWidth = width_ / 2;
+  const auto chromaHeight = height_ / 2;
+  const auto* chroma = y + width_ * height_;
+  for (auto chromaTexture : chromaTextures_)
+  {
+    glBindTexture(GL_TEXTURE_2D, chromaTexture);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, chromaWidth, chromaHeight, GL_RED, GL_UNSIGNED_BYTE, chroma);
+    chroma += chromaWidth * chromaHeight;
+  }
+
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+}
+
+void Texture::Delete()
+{
+  if (texture_)
+    glDeleteTextures(1, &texture_);
+  texture_ = 0;
+
+  for (auto& chromaTexture : chromaTextures_)
+  {
+    if (chromaTexture)
+      glDeleteTextures(1, &chromaTexture);
+    chromaTexture = 0;
+  }
+}
 }
 }
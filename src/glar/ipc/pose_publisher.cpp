@@ -0,0 +1,115 @@
+#include <glar/ipc/pose_publisher.h>
+
+#include <cstring>
+#include <new>
+#include <stdexcept>
+
+namespace glar
+{
+namespace ipc
+{
+PosePublisher::PosePublisher(const CreateInfo& createInfo)
+  : createInfo_(createInfo)
+{
+  if (createInfo.poseSlotCount == 0)
+    throw std::runtime_error("Pose channel needs at least one pose slot");
+
+  if (createInfo_.frameCapacity == 0)
+    createInfo_.frameSlotCount = 0;
+
+  const auto poseSlotCount = createInfo_.poseSlotCount;
+  const auto frameSlotCount = createInfo_.frameSlotCount;
+  const auto frameCapacity = createInfo_.frameCapacity;
+
+  memory_ = util::SharedMemory::Create(createInfo_.name, ChannelSize(poseSlotCount, frameSlotCount, frameCapacity));
+  auto* data = static_cast<uint8_t*>(memory_->Data());
+
+  // Constructed in place, readers only use them after the magic is written
+  header_ = new (data) ChannelHeader();
+  if (!IsLockFree(*header_))
+    throw std::runtime_error("Pose channel needs lock-free atomics");
+
+  header_->version = channelVersion;
+  header_->poseSlotCount = poseSlotCount;
+  header_->frameSlotCount = frameSlotCount;
+  header_->frameCapacity = frameCapacity;
+  header_->poseCount.store(0, std::memory_order_relaxed);
+  header_->frameCount.store(0, std::memory_order_relaxed);
+
+  poseSlots_ = reinterpret_cast<PoseSlot*>(data + PoseSlotsOffset());
+  for (uint32_t i = 0; i < poseSlotCount; i++)
+    new (&poseSlots_[i]) PoseSlot();
+
+  frameSlots_ = data + FrameSlotsOffset(poseSlotCount);
+  for (uint32_t i = 0; i < frameSlotCount; i++)
+  {
+    auto* slot = new (frameSlots_ + i * FrameSlotStride(frameCapacity)) FrameSlot();
+    slot->version.store(0, std::memory_order_relaxed);
+  }
+
+  header_->magic.store(channelMagic, std::memory_order_release);
+}
+
+PosePublisher::~PosePublisher()
+{
+  // Readers still mapping the channel see that the publisher is gone
+  header_->magic.store(0, std::memory_order_release);
+}
+
+bool PosePublisher::PublishesFrames() const
+{
+  return createInfo_.frameSlotCount > 0;
+}
+
+uint64_t PosePublisher::PublishPose(PoseRecord record)
+{
+  const auto sequence = stats_.poseCount;
+  record.sequence = sequence;
+  record.publishTime = Now();
+
+  // The slot holds the oldest pose, which readers behind it detect by its sequence
+  poseSlots_[sequence % createInfo_.poseSlotCount].Store(record);
+  header_->poseCount.store(sequence + 1, std::memory_order_release);
+
+  stats_.poseCount++;
+  return sequence;
+}
+
+uint64_t PosePublisher::PublishFrame(FrameInfo info, const void* data)
+{
+  if (!PublishesFrames())
+    return ~0ull;
+
+  if (info.size > createInfo_.frameCapacity)
+  {
+    stats_.oversizedFrameCount++;
+    return ~0ull;
+  }
+
+  const auto sequence = stats_.frameCount;
+  info.sequence = sequence;
+
+  // Readers holding a view of the slot find it invalidated by the odd version
+  auto& slot = frameSlot(sequence);
+  const auto version = slot.version.load(std::memory_order_relaxed);
+  slot.version.store(version + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  std::memcpy(reinterpret_cast<uint8_t*>(&slot) + FrameDataOffset(), data, info.size);
+  info.publishTime = Now();
+  slot.info.Store(info);
+
+  slot.version.store(version + 2, std::memory_order_release);
+  header_->frameCount.store(sequence + 1, std::memory_order_release);
+
+  stats_.frameCount++;
+  return sequence;
+}
+
+FrameSlot& PosePublisher::frameSlot(uint64_t index)
+{
+  const auto stride = FrameSlotStride(createInfo_.frameCapacity);
+  return *reinterpret_cast<FrameSlot*>(frameSlots_ + index % createInfo_.frameSlotCount * stride);
+}
+}
+}
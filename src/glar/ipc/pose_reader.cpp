@@ -0,0 +1,95 @@
+#include <glar/ipc/pose_reader.h>
+
+#include <stdexcept>
+
+namespace glar
+{
+namespace ipc
+{
+PoseReader::PoseReader(const std::string& name)
+  : memory_(util::SharedMemory::Open(name))
+{
+  const auto* data = static_cast<const uint8_t*>(memory_->Data());
+  header_ = reinterpret_cast<const ChannelHeader*>(data);
+
+  if (memory_->Size() < sizeof(ChannelHeader) || !Connected())
+    throw std::runtime_error("Pose channel is not published: " + name);
+
+  if (!IsLockFree(*header_))
+    throw std::runtime_error("Pose channel needs lock-free atomics: " + name);
+
+  if (memory_->Size() < ChannelSize(header_->poseSlotCount, header_->frameSlotCount, header_->frameCapacity))
+    throw std::runtime_error("Pose channel is truncated: " + name);
+
+  poseSlots_ = reinterpret_cast<const PoseSlot*>(data + PoseSlotsOffset());
+  frameSlots_ = data + FrameSlotsOffset(header_->poseSlotCount);
+
+  next_ = header_->poseCount.load(std::memory_order_acquire);
+}
+
+bool PoseReader::Connected() const
+{
+  return header_->magic.load(std::memory_order_acquire) == channelMagic && header_->version == channelVersion;
+}
+
+bool PoseReader::Next(PoseRecord& record)
+{
+  const auto slotCount = header_->poseSlotCount;
+  while (true)
+  {
+    const auto count = header_->poseCount.load(std::memory_order_acquire);
+    if (next_ >= count)
+      return false;
+
+    if (count - next_ > slotCount)
+    {
+      droppedCount_ += count - slotCount - next_;
+      next_ = count - slotCount;
+    }
+
+    record = poseSlots_[next_ % slotCount].Load();
+
+    // Overwritten by a newer pose while reading, retry from the new oldest pose
+    if (record.sequence != next_)
+      continue;
+
+    next_++;
+    return true;
+  }
+}
+
+bool PoseReader::LatestFrame(FrameView& frame) const
+{
+  const auto count = header_->frameCount.load(std::memory_order_acquire);
+  if (count == 0)
+    return false;
+
+  const auto sequence = count - 1;
+  const auto slotIndex = static_cast<uint32_t>(sequence % header_->frameSlotCount);
+  const auto& slot = frameSlot(slotIndex);
+
+  const auto version = slot.version.load(std::memory_order_acquire);
+  if (version & 1)
+    return false;
+
+  frame.info = slot.info.Load();
+  frame.data = reinterpret_cast<const uint8_t*>(&slot) + FrameDataOffset();
+  frame.slot = slotIndex;
+  frame.slotVersion = version;
+
+  // The info may already belong to a frame written after the version was read
+  return frame.info.sequence == sequence && Valid(frame);
+}
+
+bool PoseReader::Valid(const FrameView& frame) const
+{
+  std::atomic_thread_fence(std::memory_order_acquire);
+  return frameSlot(frame.slot).version.load(std::memory_order_relaxed) == frame.slotVersion;
+}
+
+const FrameSlot& PoseReader::frameSlot(uint32_t slot) const
+{
+  return *reinterpret_cast<const FrameSlot*>(frameSlots_ + slot * FrameSlotStride(header_->frameCapacity));
+}
+}
+}
@@ -0,0 +1,224 @@
+#include <glar/renderer.h>
+
+#include <algorithm>
+
+#include <glm/glm.hpp>
+
+namespace glar
+{
+namespace
+{
+constexpr float near = 0.01f;
+constexpr float far = 10.f;
+}
+
+Renderer::Renderer(const std::string& shaderDirpath, std::unique_ptr<scene::Fractal> fractal)
+  : shaderDirpath_(shaderDirpath)
+  , cameraShader_(shaderDirpath, "camera")
+  , colorShader_(shaderDirpath, "color")
+  , phongShader_(shaderDirpath, "phong")
+  , overlayShader_(shaderDirpath, "overlay")
+  , geometryArena_({ {0, 3, 6, 0}, {1, 3, 6, 3} }, 64, 256)
+  // The rect is padded to the layout of the axis, camera and overlay shaders read only its xy
+  , rectGeometry_(
+    geometryArena_,
+    {
+      0.f, 0.f, 0.f, 0.f, 0.f, 0.f,
+      1.f, 0.f, 0.f, 0.f, 0.f, 0.f,
+      0.f, 1.f, 0.f, 0.f, 0.f, 0.f,
+      1.f, 1.f, 0.f, 0.f, 0.f, 0.f,
+    },
+    { 0, 1, 2, 2, 1, 3 },
+    GL_TRIANGLES)
+  , axisGeometry_(
+    geometryArena_,
+    {
+      0.f, 0.f, 0.f, 1.f, 0.f, 0.f,
+      1.f, 0.f, 0.f, 1.f, 0.f, 0.f,
+      0.f, 0.f, 0.f, 0.f, 1.f, 0.f,
+      0.f, 1.f, 0.f, 0.f, 1.f, 0.f,
+      0.f, 0.f, 0.f, 0.f, 0.f, 1.f,
+      0.f, 0.f, 1.f, 0.f, 0.f, 1.f,
+    },
+    { 0, 1, 2, 3, 4, 5 },
+    GL_LINES)
+  , fractal_(std::move(fractal))
+  , fractalGeometry_(std::make_unique<scene::FractalGeometry>(*fractal_))
+{
+}
+
+Renderer::~Renderer() = default;
+
+void Renderer::SetFractalBackend(FractalBackend backend)
+{
+  if (backend == FractalBackend::GPU && !fractalComputeGeometry_)
+    fractalComputeGeometry_ = std::make_unique<scene::FractalComputeGeometry>(*fractal_, shaderDirpath_, fractalRingSize());
+
+  fractalBackend_ = backend;
+}
+
+void Renderer::SetFractalKeyframes(const scene::FractalKeyframes::CreateInfo& createInfo)
+{
+  fractalGeometry_->SetKeyframes(createInfo);
+}
+
+const scene::FractalKeyframes* Renderer::fractalKeyframes() const
+{
+  return fractalGeometry_->keyframes();
+}
+
+const scene::FractalKeyframes::Stats* Renderer::fractalKeyframeStats() const
+{
+  return fractalGeometry_->keyframeStats();
+}
+
+void Renderer::SetFractalSimulation(const scene::FractalSimulation::CreateInfo& createInfo)
+{
+  fractalGeometry_->SetSimulation(createInfo);
+}
+
+void Renderer::SetFractalRingSize(int ringSize)
+{
+  if (ringSize == fractalRingSize())
+    return;
+
+  // Keyframes are meshes of the old ring size, so they are generated again
+  scene::FractalKeyframes::CreateInfo keyframesCreateInfo;
+  keyframesCreateInfo.keyframeCount = 0;
+  if (const auto keyframes = fractalGeometry_->keyframes())
+    keyframesCreateInfo = keyframes->info();
+
+  scene::FractalSimulation::CreateInfo simulationCreateInfo;
+  simulationCreateInfo.timeStep = 0.;
+  if (const auto simulation = fractalGeometry_->simulation())
+    simulationCreateInfo = simulation->info();
+
+  fractalGeometry_ = std::make_unique<scene::FractalGeometry>(*fractal_, ringSize);
+  fractalGeometry_->SetKeyframes(keyframesCreateInfo);
+  fractalGeometry_->SetSimulation(simulationCreateInfo);
+
+  if (fractalComputeGeometry_)
+    fractalComputeGeometry_ = std::make_unique<scene::FractalComputeGeometry>(*fractal_, shaderDirpath_, ringSize);
+}
+
+void Renderer::SetOverlayScale(float scale)
+{
+  overlayScale_ = std::min(std::max(scale, 0.1f), 1.f);
+
+  // Full resolution draws directly into the viewport
+  if (overlayScale_ == 1.f)
+    overlayFramebuffer_ = nullptr;
+}
+
+void Renderer::UpdateAnimation(float animationTime)
+{
+  switch (fractalBackend_)
+  {
+  case FractalBackend::CPU:
+    fractalGeometry_->UpdateAnimation(animationTime);
+    break;
+
+  case FractalBackend::GPU:
+    fractalComputeGeometry_->UpdateAnimation(animationTime);
+    break;
+  }
+}
+
+void Renderer::DrawCamera(gl::Texture& cameraTexture)
+{
+  cameraShader_.Use();
+
+  cameraTexture.Bind(0);
+  cameraShader_.Uniform1i("tex", 0);
+  cameraShader_.Uniform1i("uTex", 1);
+  cameraShader_.Uniform1i("vTex", 2);
+  cameraShader_.Uniform1i("i420", cameraTexture.format() == gl::Texture::Format::I420);
+
+  // Don't write depth mask
+  // TODO: plane depth in shader instead of not writing to depth buffer
+  glDepthMask(GL_FALSE);
+  geometryArena_.Bind();
+  rectGeometry_.Draw();
+  glDepthMask(GL_TRUE);
+}
+
+void Renderer::DrawAugment(const glm::mat4& model, const glm::mat3& intrinsic, uint32_t width, uint32_t height)
+{
+  if (overlayScale_ == 1.f)
+  {
+    DrawScene(model, intrinsic, width, height);
+    return;
+  }
+
+  // Target and viewport of the caller, composited into afterwards
+  GLint framebuffer;
+  GLint viewport[4];
+  glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &framebuffer);
+  glGetIntegerv(GL_VIEWPORT, viewport);
+
+  const auto overlayWidth = std::max(static_cast<uint32_t>(viewport[2] * overlayScale_ + 0.5f), 1u);
+  const auto overlayHeight = std::max(static_cast<uint32_t>(viewport[3] * overlayScale_ + 0.5f), 1u);
+  if (!overlayFramebuffer_)
+    overlayFramebuffer_ = std::make_unique<gl::Framebuffer>(overlayWidth, overlayHeight);
+  else
+    overlayFramebuffer_->Resize(overlayWidth, overlayHeight);
+
+  overlayFramebuffer_->Clear();
+  glViewport(0, 0, overlayWidth, overlayHeight);
+  DrawScene(model, intrinsic, width, height);
+
+  glBindFramebuffer(GL_DRAW_FRAMEBUFFER, framebuffer);
+  glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+  CompositeOverlay();
+}
+
+void Renderer::DrawScene(const glm::mat4& model, const glm::mat3& intrinsic, uint32_t width, uint32_t height)
+{
+  const auto screen = glm::vec4(width, height, near, far);
+
+  // Draw axis
+  colorShader_.Use();
+  colorShader_.UniformMatrix4f("model", model);
+  colorShader_.UniformMatrix3f("intrinsic", intrinsic);
+  colorShader_.Uniform4f("screen", screen);
+
+  geometryArena_.Bind();
+  axisGeometry_.Draw();
+
+  // Draw fractal
+  phongShader_.Use();
+  phongShader_.UniformMatrix4f("model", model);
+  phongShader_.UniformMatrix3f("intrinsic", intrinsic);
+  phongShader_.Uniform4f("screen", screen);
+
+  switch (fractalBackend_)
+  {
+  case FractalBackend::CPU:
+    fractalGeometry_->Draw();
+    break;
+
+  case FractalBackend::GPU:
+    fractalComputeGeometry_->Draw();
+    break;
+  }
+}
+
+void Renderer::CompositeOverlay()
+{
+  overlayShader_.Use();
+
+  overlayFramebuffer_->BindColorTexture(0);
+  overlayFramebuffer_->BindDepthTexture(1);
+  glActiveTexture(GL_TEXTURE0);
+  overlayShader_.Uniform1i("colorTex", 0);
+  overlayShader_.Uniform1i("depthTex", 1);
+  overlayShader_.Uniform2f("depthRange", glm::vec2(near, far));
+
+  // Premultiplied over the camera image, with the depth of the nearest overlay texel
+  glEnable(GL_BLEND);
+  glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+  geometryArena_.Bind();
+  rectGeometry_.Draw();
+  glDisable(GL_BLEND);
+}
+}
@@ -1,65 +1,290 @@
 #include <glar/scene/fractal.h>
 
+#include <algorithm>
+#include <cmath>
+#include <queue>
 #include <random>
 #include <iostream>
+#include <fstream>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
 
 #include <glm/gtx/transform.hpp>
 #include <glm/gtx/quaternion.hpp>
 
+#include <glar/scene/fractal_mesh.h>
+#include <glar/util/mapped_file.h>
+#include <glar/util/philox.h>
+#include <glar/util/thread_pool.h>
+
 namespace glar
 {
 namespace scene
 {
 namespace
 {
-float rand01()
-{
-  static std::random_device rd;
-  static std::mt19937 gen(rd());
-  static std::uniform_real_distribution<float> dis(0.f, 1.f);
+// Counter domains of the generator: random values of a curve, and paths of its children
+constexpr uint32_t drawDomain = 0;
+constexpr uint32_t pathDomain = 1;
+
+// Curves of a batch smaller than this are created on the calling thread
+constexpr size_t minParallelBatchSize = 256;
 
-  return dis(gen);
+util::Philox::Counter Generate(const util::Philox& philox, uint64_t path, uint32_t index, uint32_t domain)
+{
+  return philox({ index, domain, static_cast<uint32_t>(path), static_cast<uint32_t>(path >> 32) });
 }
 
-float random(float a, float b)
+float random(uint32_t word, float a, float b)
 {
-  return a + (b - a) * rand01();
+  return a + (b - a) * util::Philox::ToFloat(word);
 }
+
+// Cache file layout: header, then curves at curveOffset
+constexpr char cacheMagic[8] = { 'G', 'L', 'A', 'R', 'F', 'R', 'C', '\0' };
+constexpr uint32_t cacheVersion = 3;
+
+struct CacheHeader
+{
+  char magic[8];
+  uint32_t version;
+  uint32_t curveSize;
+  Fractal::CreateInfo createInfo;
+  uint32_t seed;
+  uint32_t reserved;
+  uint64_t curveCount;
+  uint64_t curveOffset;
+};
+
+uint64_t AlignUp(uint64_t offset, uint64_t alignment)
+{
+  return (offset + alignment - 1) / alignment * alignment;
 }
 
-// To randomly set blossom angle
-Fractal::Curve::Curve(const Fractal::CreateInfo& createInfo)
-  : createInfo_(createInfo)
+bool operator == (const Fractal::CreateInfo& lhs, const Fractal::CreateInfo& rhs)
 {
-  blossomAngles[0] = random(0.f, 2.f * pi);
-  blossomAngles[1] = random(0.f, 0.25f * pi);
+  return std::memcmp(&lhs, &rhs, sizeof(Fractal::CreateInfo)) == 0;
+}
 }
 
 Fractal::Fractal(const CreateInfo& createInfo)
+  : Fractal(createInfo, std::random_device()())
+{
+}
+
+Fractal::Fractal(const CreateInfo& createInfo, uint32_t seed, int threadCount)
   : createInfo_(createInfo)
+  , seed_(seed)
+{
+  CreateStepTransforms();
+  CreateCurves(threadCount > 0 ? threadCount : std::max(1, static_cast<int>(std::thread::hardware_concurrency())));
+  curves_ = Curves(curveStorage_.data(), curveStorage_.size());
+}
+
+Fractal::Fractal(const std::string& cacheFilepath)
 {
-  CreateCurve(0.f, glm::mat4(1.f));
+  cacheFile_ = std::make_unique<util::MappedFile>(cacheFilepath);
+
+  const auto data = static_cast<const char*>(cacheFile_->Data());
+  const auto size = cacheFile_->Size();
+
+  if (size < sizeof(CacheHeader))
+    throw std::runtime_error("Invalid fractal cache file: " + cacheFilepath);
+
+  CacheHeader header;
+  std::memcpy(&header, data, sizeof(CacheHeader));
 
-  std::cout << curves_.size() << " curves created" << std::endl;
+  if (std::memcmp(header.magic, cacheMagic, sizeof(cacheMagic)) != 0 ||
+    header.version != cacheVersion ||
+    header.curveSize != sizeof(Curve) ||
+    header.curveOffset % alignof(Curve) != 0 ||
+    header.curveOffset + header.curveCount * sizeof(Curve) > size)
+    throw std::runtime_error("Invalid fractal cache file: " + cacheFilepath);
+
+  createInfo_ = header.createInfo;
+  seed_ = header.seed;
+
+  CreateStepTransforms();
+
+  // Curves are used in place
+  curves_ = Curves(reinterpret_cast<const Curve*>(data + header.curveOffset), header.curveCount);
+
+  std::cout << curves_.size() << " curves loaded from " << cacheFilepath << std::endl;
 }
 
 Fractal::~Fractal() = default;
 
-void Fractal::CreateCurve(float startOffset, const glm::mat4& transform)
+std::unique_ptr<Fractal> Fractal::LoadOrCreate(const std::string& cacheFilepath, const CreateInfo& createInfo, uint32_t seed)
+{
+  try
+  {
+    auto fractal = std::make_unique<Fractal>(cacheFilepath);
+    if (fractal->info() == createInfo && fractal->seed() == seed)
+      return fractal;
+
+    std::cout << "Fractal cache is outdated: " << cacheFilepath << std::endl;
+  }
+  catch (const std::exception& e)
+  {
+    std::cout << "Failed to load fractal cache: " << e.what() << std::endl;
+  }
+
+  auto fractal = std::make_unique<Fractal>(createInfo, seed);
+  fractal->Save(cacheFilepath);
+  return fractal;
+}
+
+void Fractal::Save(const std::string& filepath) const
 {
-  Curve curve(createInfo_);
+  CacheHeader header = {};
+  std::memcpy(header.magic, cacheMagic, sizeof(cacheMagic));
+  header.version = cacheVersion;
+  header.curveSize = sizeof(Curve);
+  header.createInfo = createInfo_;
+  header.seed = seed_;
+  header.curveCount = curves_.size();
+  header.curveOffset = AlignUp(sizeof(CacheHeader), alignof(Curve));
+
+  std::ofstream out(filepath, std::ios::binary);
+  if (!out)
+  {
+    std::cerr << "Failed to write fractal cache: " << filepath << std::endl;
+    return;
+  }
+
+  out.write(reinterpret_cast<const char*>(&header), sizeof(CacheHeader));
+
+  const std::vector<char> padding(header.curveOffset - sizeof(CacheHeader), 0);
+  out.write(padding.data(), padding.size());
+
+  out.write(reinterpret_cast<const char*>(curves_.data()), sizeof(Curve) * curves_.size());
+}
+
+void Fractal::CreateStepTransforms()
+{
+  // Enough for curve meshes and for division offsets
+  const auto stepCount = std::max(createInfo_.steps, static_cast<int>(createInfo_.divisionOffsetEnd));
+
+  // Scale, rotation, then translation
+  const auto stepTransform =
+    glm::translate(glm::vec3(0.f, 0.f, createInfo_.height / createInfo_.steps))
+    * glm::toMat4(glm::angleAxis(createInfo_.curveAngle / createInfo_.steps, glm::vec3(1.f, 0.f, 0.f)))
+    * glm::scale(glm::vec3(std::exp(-createInfo_.scaleCoeff)));
+
+  stepTransforms_.resize(stepCount + 1);
+  stepTransforms_[0] = glm::mat4(1.f);
+  for (int i = 1; i <= stepCount; i++)
+    stepTransforms_[i] = stepTransform * stepTransforms_[i - 1];
+}
+
+void Fractal::CreateCurves(int threadCount)
+{
+  // Curve count allowed by the budget, at least the root
+  uint64_t maxCurveCount = createInfo_.maxCurveCount > 0 ? createInfo_.maxCurveCount : UINT64_MAX;
+  if (createInfo_.maxTriangleCount > 0)
+  {
+    // Budgeted for the roundest tubes, so that the mesh fits at any ring size
+    const auto maxRingSize = *std::max_element(std::begin(FractalMesh::ringSizes), std::end(FractalMesh::ringSizes));
+    const auto curveTriangleCount = FractalMesh::MaxCurveCounts(createInfo_, maxRingSize).indexCount / 3;
+    maxCurveCount = std::min<uint64_t>(maxCurveCount, createInfo_.maxTriangleCount / curveTriangleCount);
+  }
+  maxCurveCount = std::max<uint64_t>(maxCurveCount, 1);
+
+  // Earlier branches are larger, so they are grown first. Ties keep creation order.
+  struct PendingCurve
+  {
+    Division division;
+    uint64_t order;
+  };
+  const auto later = [](const PendingCurve& lhs, const PendingCurve& rhs)
+  {
+    if (lhs.division.startOffset != rhs.division.startOffset)
+      return lhs.division.startOffset > rhs.division.startOffset;
+    return lhs.order > rhs.order;
+  };
+  std::priority_queue<PendingCurve, std::vector<PendingCurve>, decltype(later)> pending(later);
+
+  uint64_t order = 0;
+  pending.push({ { 0.f, glm::mat4(1.f), 0 }, order++ });
+
+  util::ThreadPool pool(threadCount);
+
+  std::vector<PendingCurve> batch;
+  std::vector<Curve> batchCurves;
+  std::vector<std::vector<Division>> batchDivisions;
+  while (!pending.empty() && curveStorage_.size() < maxCurveCount)
+  {
+    // Children start at least divisionOffsetBegin after their parent. Pending curves starting before that from the
+    // first one are popped ahead of all their children one by one, so they are created together in the same order.
+    const auto batchEnd = pending.top().division.startOffset + createInfo_.divisionOffsetBegin;
+    batch.clear();
+    while (!pending.empty() && curveStorage_.size() + batch.size() < maxCurveCount &&
+      (batch.empty() || pending.top().division.startOffset < batchEnd))
+    {
+      batch.push_back(pending.top());
+      pending.pop();
+    }
+
+    batchCurves.resize(batch.size());
+    batchDivisions.resize(batch.size());
+    const auto createRange = [&](size_t begin, size_t end)
+    {
+      for (size_t i = begin; i < end; i++)
+      {
+        batchDivisions[i].clear();
+        CreateCurve(batch[i].division, batchCurves[i], batchDivisions[i]);
+      }
+    };
+
+    if (batch.size() < minParallelBatchSize || pool.WorkerCount() == 1)
+      createRange(0, batch.size());
+    else
+    {
+      const auto chunkSize = (batch.size() + pool.WorkerCount() - 1) / pool.WorkerCount();
+      for (size_t begin = 0; begin < batch.size(); begin += chunkSize)
+        pool.Enqueue([&createRange, begin, end = std::min(begin + chunkSize, batch.size())] { createRange(begin, end); });
+      pool.Wait();
+    }
+
+    for (size_t i = 0; i < batch.size(); i++)
+    {
+      curveStorage_.push_back(batchCurves[i]);
+      for (const auto& division : batchDivisions[i])
+        pending.push({ division, order++ });
+    }
+  }
+
+  std::cout << curveStorage_.size() << " curves created";
+  if (!pending.empty())
+    std::cout << ", budget reached with " << pending.size() << " branches left out";
+  std::cout << std::endl;
+}
+
+void Fractal::CreateCurve(const Division& division, Curve& curve, std::vector<Division>& divisions) const
+{
+  const util::Philox philox({ seed_, 0 });
+  const auto startOffset = division.startOffset;
+  const auto& transform = division.transform;
+
+  // Random blossom angle, from the first counter of the curve
+  const auto blossomRandom = Generate(philox, division.path, 0, drawDomain);
   curve.startOffset = startOffset;
   curve.base = transform;
-  curves_.push_back(curve);
+  curve.blossomAngles[0] = random(blossomRandom[0], 0.f, 2.f * pi);
+  curve.blossomAngles[1] = random(blossomRandom[1], 0.f, 0.25f * pi);
 
   for (int i = 0; i < createInfo_.divisionCount; i++)
   {
-    const auto divisionOffset = random(createInfo_.divisionOffsetBegin, createInfo_.divisionOffsetEnd);
+    // A counter per division, drawn whether the division is grown or not
+    const auto divisionRandom = Generate(philox, division.path, i + 1, drawDomain);
+
+    const auto divisionOffset = random(divisionRandom[0], createInfo_.divisionOffsetBegin, createInfo_.divisionOffsetEnd);
     const auto offset = startOffset + divisionOffset;
     if (offset + createInfo_.minLength < createInfo_.maxLength)
     {
-      auto lateralAngle = random(createInfo_.lateralAngleBegin, createInfo_.lateralAngleEnd);
-      lateralAngle *= (rand01() < 0.5f) ? -1.f : 1.f;
+      auto lateralAngle = random(divisionRandom[1], createInfo_.lateralAngleBegin, createInfo_.lateralAngleEnd);
+      lateralAngle *= (util::Philox::ToFloat(divisionRandom[2]) < 0.5f) ? -1.f : 1.f;
 
       const auto divisionAngle = createInfo_.curveAngle * (divisionOffset / createInfo_.length);
 
@@ -80,21 +305,10 @@ void Fractal::CreateCurve(float startOffset, const glm::mat4& transform)
       divisionTransform = glm::translate(translation) * divisionTransform;
 
       // Integer part
-      for (int j = 0; j < divisionStep; j++)
-      {
-        // Scale
-        divisionTransform = glm::scale(glm::vec3(std::exp(-createInfo_.scaleCoeff))) * divisionTransform;
-
-        // Rotation
-        divisionTransform =
-          glm::toMat4(glm::angleAxis(createInfo_.curveAngle / createInfo_.steps, glm::vec3(1.f, 0.f, 0.f)))
-          * divisionTransform;
-
-        // Translation
-        divisionTransform = glm::translate(glm::vec3(0.f, 0.f, createInfo_.height / createInfo_.steps)) * divisionTransform;
-      }
+      divisionTransform = stepTransforms_[divisionStep] * divisionTransform;
 
-      CreateCurve(offset, transform * divisionTransform);
+      const auto path = Generate(philox, division.path, i, pathDomain);
+      divisions.push_back({ offset, transform * divisionTransform, path[0] | static_cast<uint64_t>(path[1]) << 32 });
     }
   }
 }
@@ -0,0 +1,136 @@
+#include <glar/scene/fractal_compute_geometry.h>
+
+#include <cstdint>
+#include <vector>
+
+#include <glar/scene/fractal_mesh.h>
+
+namespace glar
+{
+namespace scene
+{
+namespace
+{
+// std430 layout of Curve in fractal.comp
+struct CurveData
+{
+  glm::mat4 base;
+  glm::vec4 params; // [startOffset, blossomAngle0, blossomAngle1, unused]
+};
+
+// DrawElementsIndirectCommand, followed by the vertex counter
+struct Command
+{
+  uint32_t indexCount;
+  uint32_t instanceCount;
+  uint32_t firstIndex;
+  int32_t baseVertex;
+  uint32_t baseInstance;
+  uint32_t vertexCount;
+};
+
+constexpr int workGroupSize = 64;
+}
+
+FractalComputeGeometry::FractalComputeGeometry(const Fractal& fractal, const std::string& shaderDirpath, int ringSize)
+  : fractal_(fractal)
+  , ringSize_(ringSize)
+  , computeShader_(shaderDirpath, "fractal")
+{
+  const auto& curves = fractal.curves();
+  // Same bounds as the CPU mesh, which also validates the ring size
+  const FractalMesh mesh(fractal, ringSize);
+  const auto maxVertexCount = mesh.MaxVertexCount();
+  const auto maxIndexCount = mesh.MaxIndexCount();
+
+  const auto vertexByteSize = FractalMesh::vertexSize * sizeof(float);
+
+  std::vector<CurveData> curveData;
+  curveData.reserve(curves.size());
+  for (const auto& curve : curves)
+    curveData.push_back({ curve.base, glm::vec4(curve.startOffset, curve.blossomAngles[0], curve.blossomAngles[1], 0.f) });
+
+  glGenVertexArrays(1, &vao_);
+  glBindVertexArray(vao_);
+
+  glGenBuffers(4, buffers_);
+
+  glBindBuffer(GL_ARRAY_BUFFER, buffers_[0]);
+  glBufferData(GL_ARRAY_BUFFER, vertexByteSize * maxVertexCount, NULL, GL_DYNAMIC_COPY);
+
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffers_[1]);
+  glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(uint32_t) * maxIndexCount, NULL, GL_DYNAMIC_COPY);
+
+  glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(float) * 6, (void*)(sizeof(float) * 0));
+  glEnableVertexAttribArray(0);
+
+  glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(float) * 6, (void*)(sizeof(float) * 3));
+  glEnableVertexAttribArray(1);
+
+  glBindVertexArray(0);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+  // Curves are uploaded once
+  glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffers_[2]);
+  glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(CurveData) * curveData.size(), curveData.data(), GL_STATIC_DRAW);
+
+  glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffers_[3]);
+  glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(Command), NULL, GL_DYNAMIC_DRAW);
+  glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+  UpdateAnimation(0.f);
+}
+
+FractalComputeGeometry::~FractalComputeGeometry()
+{
+  glDeleteVertexArrays(1, &vao_);
+  glDeleteBuffers(4, buffers_);
+}
+
+void FractalComputeGeometry::UpdateAnimation(float animationTime)
+{
+  const auto& info = fractal_.info();
+  const auto curveCount = static_cast<uint32_t>(fractal_.curves().size());
+
+  // Reset counters
+  const Command command = { 0, 1, 0, 0, 0, 0 };
+  glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffers_[3]);
+  glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(Command), &command);
+  glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+  computeShader_.Use();
+  computeShader_.Uniform1ui("curveCount", curveCount);
+  computeShader_.Uniform1f("animationTime", animationTime);
+  computeShader_.Uniform1i("ringSize", ringSize_);
+  computeShader_.Uniform1f("height", info.height);
+  computeShader_.Uniform1i("steps", info.steps);
+  computeShader_.Uniform1f("curveLengthLimit", info.length);
+  computeShader_.Uniform1f("maxLength", info.maxLength);
+  computeShader_.Uniform1f("scaleCoeff", info.scaleCoeff);
+  computeShader_.Uniform1f("curveAngle", info.curveAngle);
+
+  glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, buffers_[2]);
+  glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, buffers_[0]);
+  glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, buffers_[1]);
+  glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, buffers_[3]);
+
+  glDispatchCompute((curveCount + workGroupSize - 1) / workGroupSize, 1, 1);
+
+  // Make the outputs visible to vertex fetch and to the indirect draw
+  glMemoryBarrier(GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT | GL_ELEMENT_ARRAY_BARRIER_BIT | GL_COMMAND_BARRIER_BIT);
+
+  for (int i = 0; i < 4; i++)
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, i, 0);
+}
+
+void FractalComputeGeometry::Draw()
+{
+  glBindVertexArray(vao_);
+  glBindBuffer(GL_DRAW_INDIRECT_BUFFER, buffers_[3]);
+  glDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, 0);
+  glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+  glBindVertexArray(0);
+}
+}
+}
@@ -0,0 +1,151 @@
+#include <glar/scene/fractal_keyframes.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace glar
+{
+namespace scene
+{
+FractalKeyframes::FractalKeyframes(const FractalMesh& mesh, const CreateInfo& createInfo)
+  : mesh_(mesh)
+  , createInfo_(createInfo)
+{
+  createInfo_.keyframeCount = std::max(createInfo_.keyframeCount, 1);
+
+  // Keyframes 0 to N/2, the rest are mirrored
+  keyframes_.resize(createInfo_.keyframeCount / 2 + 1);
+
+  stats_.keyframeCount = createInfo_.keyframeCount;
+  stats_.memoryLimit = createInfo_.memoryLimit;
+}
+
+FractalMesh::Counts FractalKeyframes::Generate(float animationTime, float* vertices, uint32_t* indices)
+{
+  const auto n = createInfo_.keyframeCount;
+  scratchStorageIndex_ = -1;
+
+  auto phase = std::fmod(animationTime / FractalMesh::period, 1.f);
+  if (phase < 0.f)
+    phase += 1.f;
+
+  const auto position = phase * n;
+  const auto index0 = static_cast<int>(position) % n;
+  const auto t = position - std::floor(position);
+
+  if (createInfo_.interpolate && t > 0.f)
+  {
+    const auto index1 = (index0 + 1) % n;
+
+    // Neighbors share the topology only when curves have the same number of steps and blossoms
+    const auto keyframe0 = Get(index0);
+    const auto keyframe1 = keyframe0 ? Get(index1) : nullptr;
+    if (keyframe0 && keyframe1)
+    {
+      const auto lower = StorageIndex(index0) < StorageIndex(index1) ? keyframe0 : keyframe1;
+      if (StorageIndex(index0) != StorageIndex(index1) && lower->sameTopologyAsNext)
+      {
+        const auto& v0 = keyframe0->vertices;
+        const auto& v1 = keyframe1->vertices;
+        for (size_t i = 0; i < v0.size(); i++)
+          vertices[i] = v0[i] + (v1[i] - v0[i]) * t;
+
+        std::memcpy(indices, keyframe0->indices.data(), sizeof(uint32_t) * keyframe0->indices.size());
+
+        stats_.interpolatedCount++;
+
+        FractalMesh::Counts counts;
+        counts.vertexCount = static_cast<uint32_t>(v0.size() / FractalMesh::vertexSize);
+        counts.indexCount = static_cast<uint32_t>(keyframe0->indices.size());
+        return counts;
+      }
+    }
+  }
+
+  // Nearest keyframe
+  const auto index = static_cast<int>(std::round(position)) % n;
+  if (const auto keyframe = Get(index))
+  {
+    stats_.hitCount++;
+    return Copy(*keyframe, vertices, indices);
+  }
+
+  // Over memory limit
+  stats_.missCount++;
+
+  // Generated just now by Get(), which is not repeated
+  if (scratchStorageIndex_ == StorageIndex(index))
+  {
+    std::memcpy(vertices, scratchVertices_.data(), sizeof(float) * FractalMesh::vertexSize * scratchCounts_.vertexCount);
+    std::memcpy(indices, scratchIndices_.data(), sizeof(uint32_t) * scratchCounts_.indexCount);
+    return scratchCounts_;
+  }
+
+  return mesh_.Generate(animationTime, vertices, indices);
+}
+
+const FractalKeyframes::Keyframe* FractalKeyframes::Get(int index)
+{
+  const auto storageIndex = StorageIndex(index);
+  auto& keyframe = keyframes_[storageIndex];
+
+  if (keyframe.generated)
+    return keyframe.stored ? &keyframe : nullptr;
+
+  keyframe.generated = true;
+
+  if (scratchVertices_.empty())
+  {
+    scratchVertices_.resize(FractalMesh::vertexSize * mesh_.MaxVertexCount());
+    scratchIndices_.resize(mesh_.MaxIndexCount());
+  }
+
+  const auto counts = mesh_.Generate(storageIndex * FractalMesh::period / createInfo_.keyframeCount,
+    scratchVertices_.data(), scratchIndices_.data());
+  scratchStorageIndex_ = storageIndex;
+  scratchCounts_ = counts;
+
+  const auto size = sizeof(float) * FractalMesh::vertexSize * counts.vertexCount + sizeof(uint32_t) * counts.indexCount;
+  if (stats_.memoryUsage + size > createInfo_.memoryLimit)
+    return nullptr;
+
+  keyframe.vertices.assign(scratchVertices_.begin(), scratchVertices_.begin() + FractalMesh::vertexSize * counts.vertexCount);
+  keyframe.indices.assign(scratchIndices_.begin(), scratchIndices_.begin() + counts.indexCount);
+  keyframe.stored = true;
+
+  stats_.memoryUsage += size;
+  stats_.storedCount++;
+
+  // Topology links to stored neighbors
+  const auto sameTopology = [](const Keyframe& lhs, const Keyframe& rhs)
+  {
+    return lhs.vertices.size() == rhs.vertices.size() && lhs.indices == rhs.indices;
+  };
+
+  if (storageIndex > 0 && keyframes_[storageIndex - 1].stored)
+    keyframes_[storageIndex - 1].sameTopologyAsNext = sameTopology(keyframes_[storageIndex - 1], keyframe);
+
+  if (storageIndex + 1 < keyframes_.size() && keyframes_[storageIndex + 1].stored)
+    keyframe.sameTopologyAsNext = sameTopology(keyframe, keyframes_[storageIndex + 1]);
+
+  return &keyframe;
+}
+
+int FractalKeyframes::StorageIndex(int index) const
+{
+  return std::min(index, createInfo_.keyframeCount - index);
+}
+
+FractalMesh::Counts FractalKeyframes::Copy(const Keyframe& keyframe, float* vertices, uint32_t* indices) const
+{
+  std::memcpy(vertices, keyframe.vertices.data(), sizeof(float) * keyframe.vertices.size());
+  std::memcpy(indices, keyframe.indices.data(), sizeof(uint32_t) * keyframe.indices.size());
+
+  FractalMesh::Counts counts;
+  counts.vertexCount = static_cast<uint32_t>(keyframe.vertices.size() / FractalMesh::vertexSize);
+  counts.indexCount = static_cast<uint32_t>(keyframe.indices.size());
+  return counts;
+}
+}
+}
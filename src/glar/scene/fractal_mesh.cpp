@@ -0,0 +1,350 @@
+#include <glar/scene/fractal_mesh.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <glm/gtx/transform.hpp>
+#include <glm/gtx/quaternion.hpp>
+
+#include <glar/scene/ring_transform.h>
+
+namespace glar
+{
+namespace scene
+{
+constexpr int FractalMesh::ringSizes[];
+
+namespace
+{
+constexpr float pi = 3.1415926535897932384626433832795f;
+
+// Also in shader/fractal.comp
+constexpr int maxBlossomCount = 100;
+
+// Taylor series, for ring tables at compile time. Accurate to double precision in [-pi, pi].
+constexpr double Sin(double x)
+{
+  double term = x;
+  double sum = x;
+  for (int i = 1; i < 20; i++)
+  {
+    term *= -x * x / ((2 * i) * (2 * i + 1));
+    sum += term;
+  }
+  return sum;
+}
+
+constexpr double Cos(double x)
+{
+  return Sin(x + 3.14159265358979323846 / 2.);
+}
+
+// Fixed size array that constexpr functions of C++14 can fill
+template <typename T, size_t Size>
+struct Table
+{
+  T values[Size];
+};
+
+/**
+* Ring and index tables of tubes with ringSize vertices per ring
+*/
+template <int RingSize>
+struct TubeTables
+{
+  // Counter clockwise, starting at the same corner as the square ring of size 4: (-0.5, -0.5)
+  static constexpr Table<float, 2 * RingSize> MakeRing()
+  {
+    constexpr double radius = 0.70710678118654752; // 0.5 * sqrt(2)
+    constexpr double twoPi = 2. * 3.14159265358979323846;
+
+    Table<float, 2 * RingSize> ring = {};
+    for (int j = 0; j < RingSize; j++)
+    {
+      auto angle = -0.75 * 3.14159265358979323846 + twoPi * j / RingSize;
+      if (angle > 3.14159265358979323846)
+        angle -= twoPi;
+
+      ring.values[2 * j + 0] = static_cast<float>(radius * Cos(angle));
+      ring.values[2 * j + 1] = static_cast<float>(radius * Sin(angle));
+    }
+    return ring;
+  }
+
+  // Two triangles for each ring edge between ring i and i + 1, relative to the first vertex of ring i
+  static constexpr Table<uint32_t, 6 * RingSize> MakeBand()
+  {
+    Table<uint32_t, 6 * RingSize> band = {};
+    for (uint32_t j = 0; j < RingSize; j++)
+    {
+      const auto j0 = j;
+      const auto j1 = (j + 1) % RingSize;
+
+      band.values[6 * j + 0] = j0;
+      band.values[6 * j + 1] = j1;
+      band.values[6 * j + 2] = j0 + RingSize;
+      band.values[6 * j + 3] = j0 + RingSize;
+      band.values[6 * j + 4] = j1;
+      band.values[6 * j + 5] = j1 + RingSize;
+    }
+    return band;
+  }
+
+  // Faces from the last ring to the tip vertex after it, relative to the first vertex of the last ring
+  static constexpr Table<uint32_t, 3 * RingSize> MakeTip()
+  {
+    Table<uint32_t, 3 * RingSize> tip = {};
+    for (uint32_t j = 0; j < RingSize; j++)
+    {
+      tip.values[3 * j + 0] = j;
+      tip.values[3 * j + 1] = (j + 1) % RingSize;
+      tip.values[3 * j + 2] = RingSize;
+    }
+    return tip;
+  }
+
+  static constexpr Table<float, 2 * RingSize> ring = MakeRing();
+  static constexpr Table<uint32_t, 6 * RingSize> band = MakeBand();
+  static constexpr Table<uint32_t, 3 * RingSize> tip = MakeTip();
+};
+
+template <int RingSize>
+constexpr Table<float, 2 * RingSize> TubeTables<RingSize>::ring;
+template <int RingSize>
+constexpr Table<uint32_t, 6 * RingSize> TubeTables<RingSize>::band;
+template <int RingSize>
+constexpr Table<uint32_t, 3 * RingSize> TubeTables<RingSize>::tip;
+
+static_assert(TubeTables<4>::ring.values[0] == -0.5f && TubeTables<4>::ring.values[5] == 0.5f, "Ring of size 4 is the unit square");
+
+// Ring vertices for TransformRings, made once from the tables
+template <int RingSize>
+const std::array<glm::vec3, RingSize> ringVertices = []
+{
+  std::array<glm::vec3, RingSize> vertices;
+  for (int j = 0; j < RingSize; j++)
+    vertices[j] = glm::vec3(TubeTables<RingSize>::ring.values[2 * j], TubeTables<RingSize>::ring.values[2 * j + 1], 0.f);
+  return vertices;
+}();
+
+class MeshWriter
+{
+public:
+  MeshWriter(float* vertices, uint32_t* indices)
+    : vertices_(vertices), indices_(indices)
+  {
+  }
+
+  uint32_t VertexCount() const { return vertexCount_; }
+  uint32_t IndexCount() const { return indexCount_; }
+
+  void Vertex(const glm::vec3& position, const glm::vec3& color)
+  {
+    // Sequential writes only, the target may be write-combined memory
+    auto v = vertices_ + FractalMesh::vertexSize * vertexCount_;
+    v[0] = position.x;
+    v[1] = position.y;
+    v[2] = position.z;
+    v[3] = color.r;
+    v[4] = color.g;
+    v[5] = color.b;
+    vertexCount_++;
+  }
+
+  // Reserves count vertices to be written directly
+  float* Vertices(uint32_t count)
+  {
+    auto v = vertices_ + FractalMesh::vertexSize * vertexCount_;
+    vertexCount_ += count;
+    return v;
+  }
+
+  void Triangle(uint32_t i0, uint32_t i1, uint32_t i2)
+  {
+    auto i = indices_ + indexCount_;
+    i[0] = i0;
+    i[1] = i1;
+    i[2] = i2;
+    indexCount_ += 3;
+  }
+
+  // Index pattern offset by base, unrolled for the fixed pattern size
+  template <size_t Size>
+  void Indices(const Table<uint32_t, Size>& pattern, uint32_t base)
+  {
+    auto i = indices_ + indexCount_;
+    for (size_t k = 0; k < Size; k++)
+      i[k] = base + pattern.values[k];
+    indexCount_ += Size;
+  }
+
+private:
+  float* vertices_;
+  uint32_t* indices_;
+  uint32_t vertexCount_ = 0;
+  uint32_t indexCount_ = 0;
+};
+
+template <int RingSize>
+void AppendCurve(MeshWriter& writer, const Fractal& fractal, const Fractal::Curve& curve, float length, float* ringScales)
+{
+  using Tables = TubeTables<RingSize>;
+
+  const auto& info = fractal.info();
+  const auto indexOffset = writer.VertexCount();
+
+  const auto curveLength = std::min<float>(info.steps, std::max(length - curve.startOffset, 0.f));
+  if (curveLength <= 0.f)
+    return;
+
+  const auto steps = static_cast<int>(curveLength);
+
+  const auto restLength = curveLength - steps;
+  const auto& stepTransforms = fractal.stepTransforms();
+  const glm::vec3 color = glm::vec3(0.25f, 0.25f, 0.25f);
+
+  // Tip is sharp, root is thick
+  for (int i = 0; i <= steps; i++)
+    ringScales[i] = 1.f;
+  ringScales[steps] = restLength;
+  if (curve.startOffset == 0.f)
+    ringScales[0] = 2.f;
+
+  TransformRings(curve.base, stepTransforms.data(), ringScales, steps + 1, ringVertices<RingSize>.data(), RingSize, color,
+    writer.Vertices((steps + 1) * RingSize));
+  const auto& transform = stepTransforms[steps];
+
+  // Vertex at end
+  writer.Vertex(glm::vec3(curve.base * transform * glm::vec4(0.f, 0.f, restLength * info.height / info.steps, 1.f)), color);
+
+  for (int i = 0; i < steps; i++)
+    writer.Indices(Tables::band, indexOffset + i * RingSize);
+
+  // Faces at end
+  writer.Indices(Tables::tip, indexOffset + steps * RingSize);
+
+  // Blossoms
+  if (curveLength == steps)
+  {
+    constexpr float blossomDuration = 2.f;
+    constexpr float blossomFrequency = 0.02f;
+    constexpr float blossomSize = 0.75f;
+    constexpr float blossomAngle = 1.f; // Some random angle in radian
+    constexpr float blossomGap = blossomSize / (blossomDuration / blossomFrequency);
+
+    const glm::vec3 blossomVertices[3] = {
+      glm::vec3(0.f, 0.f, 0.f),
+      glm::vec3(1.f, 0.f, 1.f),
+      glm::vec3(-1.f, 0.f, 1.f),
+    };
+    const glm::vec3 blossomColors[3] = {
+      glm::vec3(0.5f, 0.5f, 0.5f),
+      glm::vec3(1.f, 1.f, 1.f),
+      glm::vec3(1.f, 1.f, 1.f),
+    };
+
+    const auto blossomTime = std::min(length - curve.startOffset - info.length, blossomDuration);
+    const auto blossomCount = std::min(static_cast<int>(blossomTime / blossomFrequency), maxBlossomCount);
+
+    if (blossomCount > 0)
+    {
+      // Create Z-up
+      const auto position = glm::vec3((curve.base * transform)[3]);
+
+      const auto indexOffset = writer.VertexCount();
+      for (int i = 0; i < blossomCount; i++)
+      {
+        const auto distance = blossomGap * i;
+
+        const auto t = static_cast<float>(i) / blossomCount;
+
+        glm::mat4 transform =
+          glm::translate(glm::vec3(position + glm::vec3(0.f, 0.f, distance)))
+          * glm::toMat4(glm::angleAxis(curve.blossomAngles[0], glm::vec3(0.f, 0.f, 1.f)))
+          * glm::toMat4(glm::angleAxis(curve.blossomAngles[1], glm::vec3(1.f, 0.f, 0.f)))
+          * glm::toMat4(glm::angleAxis(blossomAngle * i, glm::vec3(0.f, 0.f, 1.f)))
+          * glm::toMat4(glm::angleAxis(-pi / 3.f, glm::vec3(1.f, 0.f, 0.f)))
+          * glm::scale(glm::vec3(blossomSize * (1.f - t)));
+
+        for (int j = 0; j < 3; j++)
+          writer.Vertex(glm::vec3(transform * glm::vec4(blossomVertices[j], 1.f)), blossomColors[j]);
+
+        writer.Triangle(indexOffset + i * 3, indexOffset + i * 3 + 1, indexOffset + i * 3 + 2);
+      }
+    }
+  }
+}
+
+template <int RingSize>
+FractalMesh::Counts AppendCurves(const Fractal& fractal, float length, float* ringScales, float* vertices, uint32_t* indices)
+{
+  MeshWriter writer(vertices, indices);
+  for (const auto& curve : fractal.curves())
+    AppendCurve<RingSize>(writer, fractal, curve, length, ringScales);
+
+  FractalMesh::Counts counts;
+  counts.vertexCount = writer.VertexCount();
+  counts.indexCount = writer.IndexCount();
+  return counts;
+}
+}
+
+bool FractalMesh::IsRingSize(int ringSize)
+{
+  return std::find(std::begin(ringSizes), std::end(ringSizes), ringSize) != std::end(ringSizes);
+}
+
+FractalMesh::Counts FractalMesh::MaxCurveCounts(const Fractal::CreateInfo& createInfo, int ringSize)
+{
+  const auto steps = static_cast<uint32_t>(createInfo.steps);
+
+  Counts counts;
+
+  // Rings for each step plus the base ring, one tip vertex, then blossoms
+  counts.vertexCount = ringSize * (steps + 1) + 1 + 3 * maxBlossomCount;
+
+  // 2 triangles for each ring edge of each step, tip faces, then blossoms
+  counts.indexCount = 6 * ringSize * steps + 3 * ringSize + 3 * maxBlossomCount;
+
+  return counts;
+}
+
+FractalMesh::FractalMesh(const Fractal& fractal, int ringSize)
+  : fractal_(fractal)
+  , ringSize_(ringSize)
+{
+  if (!IsRingSize(ringSize))
+    throw std::runtime_error("Unsupported tube ring size: " + std::to_string(ringSize));
+
+  const auto curveCount = static_cast<uint32_t>(fractal.curves().size());
+  const auto curveCounts = MaxCurveCounts(fractal.info(), ringSize);
+
+  maxCounts_.vertexCount = curveCount * curveCounts.vertexCount;
+  maxCounts_.indexCount = curveCount * curveCounts.indexCount;
+
+  ringScales_.resize(fractal.info().steps + 1);
+}
+
+FractalMesh::Counts FractalMesh::Generate(float animationTime, float* vertices, uint32_t* indices) const
+{
+  const auto& info = fractal_.info();
+
+  // Animation time to length
+  const auto length = (-std::cos(2.f * pi * animationTime / period) + 1.f) / 2.f * (info.maxLength + 2.f);
+
+  switch (ringSize_)
+  {
+  case 6: return AppendCurves<6>(fractal_, length, ringScales_.data(), vertices, indices);
+  case 8: return AppendCurves<8>(fractal_, length, ringScales_.data(), vertices, indices);
+  case 12: return AppendCurves<12>(fractal_, length, ringScales_.data(), vertices, indices);
+  case 4:
+  default: return AppendCurves<4>(fractal_, length, ringScales_.data(), vertices, indices);
+  }
+}
+}
+}
@@ -0,0 +1,97 @@
+#include <glar/scene/fractal_simulation.h>
+
+#include <cmath>
+#include <stdexcept>
+
+namespace glar
+{
+namespace scene
+{
+FractalSimulation::FractalSimulation(const FractalMesh& mesh, FractalKeyframes* keyframes, const CreateInfo& createInfo)
+  : mesh_(mesh)
+  , keyframes_(keyframes)
+  , createInfo_(createInfo)
+{
+  if (createInfo.timeStep <= 0.)
+    throw std::runtime_error("Fractal simulation time step must be positive");
+
+  // Sized once, so generation doesn't allocate
+  for (auto& frame : frames_)
+  {
+    frame.vertices.resize(FractalMesh::vertexSize * static_cast<size_t>(mesh.MaxVertexCount()));
+    frame.indices.resize(mesh.MaxIndexCount());
+  }
+
+  thread_ = std::thread([this] { Run(); });
+}
+
+FractalSimulation::~FractalSimulation()
+{
+  {
+    std::unique_lock<std::mutex> guard(mutex_);
+    terminate_ = true;
+  }
+  condition_.notify_one();
+
+  thread_.join();
+}
+
+const FractalSimulation::Frame* FractalSimulation::Update(double animationTime)
+{
+  const auto step = static_cast<int64_t>(std::floor(animationTime / createInfo_.timeStep)) + 1;
+
+  const Frame* frame = nullptr;
+  {
+    std::unique_lock<std::mutex> guard(mutex_);
+    if (backReady_)
+    {
+      front_ = 1 - front_;
+      backReady_ = false;
+      frame = &frames_[front_];
+    }
+
+    targetStep_ = step;
+  }
+  condition_.notify_one();
+
+  return frame;
+}
+
+void FractalSimulation::Run()
+{
+  std::unique_lock<std::mutex> guard(mutex_);
+  while (true)
+  {
+    // The back frame is free and there is a step not generated yet
+    condition_.wait(guard, [this] { return terminate_ || (!backReady_ && targetStep_ >= 0 && targetStep_ != generatedStep_); });
+    if (terminate_)
+      return;
+
+    // Only the render thread swaps, so the back frame stays the back frame while unlocked
+    const auto step = targetStep_;
+    auto& frame = frames_[1 - front_];
+
+    guard.unlock();
+    Generate(frame, step);
+    guard.lock();
+
+    generatedStep_ = step;
+    backReady_ = true;
+  }
+}
+
+void FractalSimulation::Generate(Frame& frame, int64_t step)
+{
+  const auto animationTime = static_cast<float>(step * createInfo_.timeStep);
+
+  frame.step = step;
+  if (keyframes_)
+  {
+    frame.counts = keyframes_->Generate(animationTime, frame.vertices.data(), frame.indices.data());
+    frame.keyframeStats = keyframes_->stats();
+  }
+  else
+    frame.counts = mesh_.Generate(animationTime, frame.vertices.data(), frame.indices.data());
+}
+}
+}
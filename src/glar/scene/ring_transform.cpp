@@ -0,0 +1,235 @@
+#include <glar/scene/ring_transform.h>
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define GLAR_RING_TRANSFORM_X64
+#endif
+
+#ifdef GLAR_RING_TRANSFORM_X64
+#include <immintrin.h>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+
+// MSVC allows AVX intrinsics without /arch:AVX
+#define GLAR_TARGET_AVX
+#else
+#define GLAR_TARGET_AVX __attribute__((target("avx")))
+#endif
+#endif
+
+namespace glar
+{
+namespace scene
+{
+namespace
+{
+// Kernels are instantiated for the tube ring sizes, so that the ring loop is unrolled. RingSize 0 takes the ring size
+// at run time.
+template <int RingSize>
+void TransformRingsScalar(const glm::mat4& base, const glm::mat4* stepTransforms, const float* ringScales, int stepCount,
+  const glm::vec3* ring, int ringSize, const glm::vec3& color, float* vertices)
+{
+  for (int i = 0; i < stepCount; i++)
+  {
+    const glm::mat4 transform = base * stepTransforms[i];
+
+    for (int j = 0; j < (RingSize > 0 ? RingSize : ringSize); j++)
+    {
+      const auto v = transform * glm::vec4(ring[j] * ringScales[i], 1.f);
+      vertices[0] = v.x;
+      vertices[1] = v.y;
+      vertices[2] = v.z;
+      vertices[3] = color.r;
+      vertices[4] = color.g;
+      vertices[5] = color.b;
+      vertices += 6;
+    }
+  }
+}
+
+#ifdef GLAR_RING_TRANSFORM_X64
+// Columns of base * step, with the first three scaled by the ring scale
+inline void StepColumns(const __m128 baseColumns[4], const float* step, float scale, __m128 columns[4])
+{
+  for (int k = 0; k < 4; k++)
+  {
+    auto column = _mm_mul_ps(baseColumns[0], _mm_set1_ps(step[4 * k + 0]));
+    column = _mm_add_ps(column, _mm_mul_ps(baseColumns[1], _mm_set1_ps(step[4 * k + 1])));
+    column = _mm_add_ps(column, _mm_mul_ps(baseColumns[2], _mm_set1_ps(step[4 * k + 2])));
+    column = _mm_add_ps(column, _mm_mul_ps(baseColumns[3], _mm_set1_ps(step[4 * k + 3])));
+    columns[k] = column;
+  }
+
+  const auto s = _mm_set1_ps(scale);
+  columns[0] = _mm_mul_ps(columns[0], s);
+  columns[1] = _mm_mul_ps(columns[1], s);
+  columns[2] = _mm_mul_ps(columns[2], s);
+}
+
+// Writes [x, y, z, r] then [g, b], replacing w by red
+inline void StoreVertex(float* vertex, __m128 position, __m128 rgb0)
+{
+  const auto zr = _mm_shuffle_ps(position, rgb0, _MM_SHUFFLE(0, 0, 2, 2));
+  _mm_storeu_ps(vertex, _mm_shuffle_ps(position, zr, _MM_SHUFFLE(2, 0, 1, 0)));
+  _mm_storel_pi(reinterpret_cast<__m64*>(vertex + 4), _mm_shuffle_ps(rgb0, rgb0, _MM_SHUFFLE(3, 3, 2, 1)));
+}
+
+template <int RingSize>
+void TransformRingsSse(const glm::mat4& base, const glm::mat4* stepTransforms, const float* ringScales, int stepCount,
+  const glm::vec3* ring, int ringSize, const glm::vec3& color, float* vertices)
+{
+  __m128 baseColumns[4];
+  for (int k = 0; k < 4; k++)
+    baseColumns[k] = _mm_loadu_ps(&base[k][0]);
+
+  const auto rgb0 = _mm_setr_ps(color.r, color.g, color.b, 0.f);
+
+  for (int i = 0; i < stepCount; i++)
+  {
+    __m128 columns[4];
+    StepColumns(baseColumns, &stepTransforms[i][0][0], ringScales[i], columns);
+
+    for (int j = 0; j < (RingSize > 0 ? RingSize : ringSize); j++)
+    {
+      auto v = _mm_add_ps(columns[3], _mm_mul_ps(columns[0], _mm_set1_ps(ring[j].x)));
+      v = _mm_add_ps(v, _mm_mul_ps(columns[1], _mm_set1_ps(ring[j].y)));
+      v = _mm_add_ps(v, _mm_mul_ps(columns[2], _mm_set1_ps(ring[j].z)));
+
+      StoreVertex(vertices, v, rgb0);
+      vertices += 6;
+    }
+  }
+}
+
+// Two ring vertices per iteration, one in each 128-bit lane
+template <int RingSize>
+GLAR_TARGET_AVX
+void TransformRingsAvx(const glm::mat4& base, const glm::mat4* stepTransforms, const float* ringScales, int stepCount,
+  const glm::vec3* ring, int ringSize, const glm::vec3& color, float* vertices)
+{
+  __m128 baseColumns[4];
+  for (int k = 0; k < 4; k++)
+    baseColumns[k] = _mm_loadu_ps(&base[k][0]);
+
+  const auto rgb0 = _mm_setr_ps(color.r, color.g, color.b, 0.f);
+  const auto m = RingSize > 0 ? RingSize : ringSize;
+
+  for (int i = 0; i < stepCount; i++)
+  {
+    __m128 columns[4];
+    StepColumns(baseColumns, &stepTransforms[i][0][0], ringScales[i], columns);
+
+    __m256 wideColumns[4];
+    for (int k = 0; k < 4; k++)
+      wideColumns[k] = _mm256_insertf128_ps(_mm256_castps128_ps256(columns[k]), columns[k], 1);
+
+    int j = 0;
+    for (; j + 1 < m; j += 2)
+    {
+      const auto& r0 = ring[j];
+      const auto& r1 = ring[j + 1];
+
+      auto v = _mm256_add_ps(wideColumns[3], _mm256_mul_ps(wideColumns[0], _mm256_setr_ps(r0.x, r0.x, r0.x, r0.x, r1.x, r1.x, r1.x, r1.x)));
+      v = _mm256_add_ps(v, _mm256_mul_ps(wideColumns[1], _mm256_setr_ps(r0.y, r0.y, r0.y, r0.y, r1.y, r1.y, r1.y, r1.y)));
+      v = _mm256_add_ps(v, _mm256_mul_ps(wideColumns[2], _mm256_setr_ps(r0.z, r0.z, r0.z, r0.z, r1.z, r1.z, r1.z, r1.z)));
+
+      StoreVertex(vertices, _mm256_castps256_ps128(v), rgb0);
+      StoreVertex(vertices + 6, _mm256_extractf128_ps(v, 1), rgb0);
+      vertices += 12;
+    }
+
+    for (; j < m; j++)
+    {
+      auto v = _mm_add_ps(columns[3], _mm_mul_ps(columns[0], _mm_set1_ps(ring[j].x)));
+      v = _mm_add_ps(v, _mm_mul_ps(columns[1], _mm_set1_ps(ring[j].y)));
+      v = _mm_add_ps(v, _mm_mul_ps(columns[2], _mm_set1_ps(ring[j].z)));
+
+      StoreVertex(vertices, v, rgb0);
+      vertices += 6;
+    }
+  }
+
+  _mm256_zeroupper();
+}
+
+bool CpuSupportsAvx()
+{
+#ifdef _MSC_VER
+  int info[4];
+  __cpuid(info, 1);
+
+  // AVX and OSXSAVE, then the OS saves YMM registers
+  const bool avx = (info[2] & (1 << 28)) != 0;
+  const bool osxsave = (info[2] & (1 << 27)) != 0;
+  return avx && osxsave && (_xgetbv(0) & 0x6) == 0x6;
+#else
+  return __builtin_cpu_supports("avx");
+#endif
+}
+#endif
+
+template <int RingSize>
+void TransformRingsKernel(const glm::mat4& base, const glm::mat4* stepTransforms, const float* ringScales, int stepCount,
+  const glm::vec3* ring, int ringSize, const glm::vec3& color, float* vertices, RingTransformIsa isa)
+{
+#ifdef GLAR_RING_TRANSFORM_X64
+  switch (isa)
+  {
+  case RingTransformIsa::AVX:
+    TransformRingsAvx<RingSize>(base, stepTransforms, ringScales, stepCount, ring, ringSize, color, vertices);
+    return;
+  case RingTransformIsa::SSE:
+    TransformRingsSse<RingSize>(base, stepTransforms, ringScales, stepCount, ring, ringSize, color, vertices);
+    return;
+  default:
+    break;
+  }
+#endif
+
+  TransformRingsScalar<RingSize>(base, stepTransforms, ringScales, stepCount, ring, ringSize, color, vertices);
+}
+}
+
+const char* ToString(RingTransformIsa isa)
+{
+  switch (isa)
+  {
+  case RingTransformIsa::SSE:
+    return "sse";
+  case RingTransformIsa::AVX:
+    return "avx";
+  default:
+    return "scalar";
+  }
+}
+
+RingTransformIsa BestRingTransformIsa()
+{
+#ifdef GLAR_RING_TRANSFORM_X64
+  static const auto isa = CpuSupportsAvx() ? RingTransformIsa::AVX : RingTransformIsa::SSE;
+  return isa;
+#else
+  return RingTransformIsa::SCALAR;
+#endif
+}
+
+void TransformRings(const glm::mat4& base, const glm::mat4* stepTransforms, const float* ringScales, int stepCount,
+  const glm::vec3* ring, int ringSize, const glm::vec3& color, float* vertices)
+{
+  TransformRings(base, stepTransforms, ringScales, stepCount, ring, ringSize, color, vertices, BestRingTransformIsa());
+}
+
+void TransformRings(const glm::mat4& base, const glm::mat4* stepTransforms, const float* ringScales, int stepCount,
+  const glm::vec3* ring, int ringSize, const glm::vec3& color, float* vertices, RingTransformIsa isa)
+{
+  switch (ringSize)
+  {
+  case 4: return TransformRingsKernel<4>(base, stepTransforms, ringScales, stepCount, ring, ringSize, color, vertices, isa);
+  case 6: return TransformRingsKernel<6>(base, stepTransforms, ringScales, stepCount, ring, ringSize, color, vertices, isa);
+  case 8: return TransformRingsKernel<8>(base, stepTransforms, ringScales, stepCount, ring, ringSize, color, vertices, isa);
+  case 12: return TransformRingsKernel<12>(base, stepTransforms, ringScales, stepCount, ring, ringSize, color, vertices, isa);
+  default: return TransformRingsKernel<0>(base, stepTransforms, ringScales, stepCount, ring, ringSize, color, vertices, isa);
+  }
+}
+}
+}
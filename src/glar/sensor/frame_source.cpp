@@ -0,0 +1,185 @@
+#include <glar/sensor/frame_source.h>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+#include <glar/sensor/mjpeg_stream.h>
+#include <glar/sensor/video_capture.h>
+
+namespace glar
+{
+namespace sensor
+{
+constexpr double FrameSourceStats::jitterBinBounds[];
+
+namespace
+{
+constexpr double averageWeight = 0.1;
+
+// Reconnect wait doubles from the minimum with every failure
+constexpr double minReconnectWait = 0.25;
+constexpr double maxReconnectWait = 8.;
+}
+
+std::unique_ptr<FrameSource> FrameSource::Create(const std::string& address, const CreateInfo& createInfo)
+{
+  switch (createInfo.type)
+  {
+  case Type::MJPEG:
+    return std::make_unique<MjpegStream>(address, createInfo.scaleDenominator, createInfo.i420);
+
+  case Type::OPENCV:
+  default:
+    return std::make_unique<VideoCapture>(address);
+  }
+}
+
+const char* FrameSource::ToString(Type type)
+{
+  switch (type)
+  {
+  case Type::OPENCV: return "OpenCV";
+  case Type::MJPEG: return "MJPEG";
+  default: return "Unknown";
+  }
+}
+
+FrameSource::FrameSource()
+{
+  snapshot_.lastFrameTime = std::chrono::high_resolution_clock::now();
+  Publish();
+}
+
+FrameSource::~FrameSource() = default;
+
+FrameSourceStats FrameSource::Stats() const
+{
+  const auto snapshot = publishedSnapshot_.Load();
+
+  auto stats = snapshot.stats;
+  stats.stallDuration = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - snapshot.lastFrameTime).count();
+  if (stats.frameCount > 0)
+    stats.maxStallDuration = std::max(stats.maxStallDuration, stats.stallDuration);
+  return stats;
+}
+
+cv::Mat FrameSource::Image()
+{
+  std::chrono::high_resolution_clock::time_point captureTime;
+  return Image(captureTime);
+}
+
+cv::Mat FrameSource::Image(std::chrono::high_resolution_clock::time_point& captureTime)
+{
+  std::unique_lock<std::mutex> guard(mutex_);
+  auto result = image_;
+  captureTime = captureTime_;
+  image_ = cv::Mat();
+  return result;
+}
+
+void FrameSource::Opened(double targetFps)
+{
+  std::unique_lock<std::mutex> guard(statsMutex_);
+  if (opened_)
+    snapshot_.stats.reconnectCount++;
+  opened_ = true;
+
+  // The first frame interval of a connection includes the connection time
+  receiving_ = false;
+
+  snapshot_.stats.targetFps = targetFps;
+  Publish();
+}
+
+void FrameSource::UpdateTargetFps(double targetFps)
+{
+  std::unique_lock<std::mutex> guard(statsMutex_);
+  snapshot_.stats.targetFps = targetFps;
+  Publish();
+}
+
+void FrameSource::UpdateImage(cv::Mat image, std::chrono::high_resolution_clock::time_point captureTime, double readTime, double decodeTime)
+{
+  {
+    std::unique_lock<std::mutex> guard(mutex_);
+    image_ = image;
+    captureTime_ = captureTime;
+  }
+
+  const auto currentTime = std::chrono::high_resolution_clock::now();
+
+  std::unique_lock<std::mutex> guard(statsMutex_);
+  auto& stats = snapshot_.stats;
+
+  const auto interval = std::chrono::duration<double>(currentTime - snapshot_.lastFrameTime).count();
+  if (stats.frameCount > 0)
+    stats.maxStallDuration = std::max(stats.maxStallDuration, interval);
+
+  if (receiving_)
+  {
+    if (stats.averageInterval > 0.)
+    {
+      const auto jitter = std::abs(interval - stats.averageInterval);
+      const auto bin = std::upper_bound(std::begin(FrameSourceStats::jitterBinBounds), std::end(FrameSourceStats::jitterBinBounds), jitter)
+        - std::begin(FrameSourceStats::jitterBinBounds);
+      stats.jitterHistogram[bin]++;
+
+      stats.averageInterval = (1. - averageWeight) * stats.averageInterval + averageWeight * interval;
+    }
+    else
+      stats.averageInterval = interval;
+
+    if (stats.averageInterval > 0.)
+      stats.fps = 1. / stats.averageInterval;
+  }
+
+  if (stats.frameCount == 0)
+  {
+    stats.averageReadTime = readTime;
+    stats.averageDecodeTime = decodeTime;
+  }
+  else
+  {
+    stats.averageReadTime = (1. - averageWeight) * stats.averageReadTime + averageWeight * readTime;
+    stats.averageDecodeTime = (1. - averageWeight) * stats.averageDecodeTime + averageWeight * decodeTime;
+  }
+
+  stats.frameCount++;
+  snapshot_.lastFrameTime = currentTime;
+  receiving_ = true;
+  failureCount_ = 0;
+
+  Publish();
+}
+
+bool FrameSource::WaitReconnect()
+{
+  double wait;
+  {
+    std::unique_lock<std::mutex> guard(statsMutex_);
+    wait = std::min(minReconnectWait * std::pow(2., failureCount_), maxReconnectWait);
+    failureCount_++;
+  }
+
+  std::cout << "Reconnecting in " << wait << "s..." << std::endl;
+
+  std::unique_lock<std::mutex> guard(terminateMutex_);
+  return !terminateCondition_.wait_for(guard, std::chrono::duration<double>(wait), [this] { return terminate_.load(); });
+}
+
+void FrameSource::Terminate()
+{
+  terminate_ = true;
+
+  std::unique_lock<std::mutex> guard(terminateMutex_);
+  terminateCondition_.notify_all();
+}
+
+void FrameSource::Publish()
+{
+  publishedSnapshot_.Store(snapshot_);
+}
+}
+}
@@ -0,0 +1,119 @@
+#include <glar/sensor/jpeg_decoder.h>
+
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+#include <opencv2/imgproc.hpp>
+#include <turbojpeg.h>
+
+namespace glar
+{
+namespace sensor
+{
+namespace
+{
+// Frames held by the scheduler queue, the detection workers and the result of each stream
+constexpr int poolCapacity = 8;
+}
+
+JpegDecoder::JpegDecoder()
+  : pool_(poolCapacity)
+{
+  handle_ = tjInitDecompress();
+  if (handle_ == nullptr)
+    throw std::runtime_error("Failed to initialize JPEG decoder");
+}
+
+JpegDecoder::~JpegDecoder()
+{
+  tjDestroy(handle_);
+}
+
+cv::Mat JpegDecoder::Decode(const uint8_t* data, size_t size, int scaleDenominator)
+{
+  int width = 0;
+  int height = 0;
+  int subsampling = 0;
+  int colorspace = 0;
+  if (tjDecompressHeader3(handle_, data, static_cast<unsigned long>(size), &width, &height, &subsampling, &colorspace) != 0)
+  {
+    std::cerr << "Failed to read JPEG header: " << tjGetErrorStr2(handle_) << std::endl;
+    return cv::Mat();
+  }
+
+  // Supported by every libjpeg-turbo version
+  if (scaleDenominator != 1 && scaleDenominator != 2 && scaleDenominator != 4 && scaleDenominator != 8)
+    throw std::runtime_error("Unsupported JPEG scale denominator: " + std::to_string(scaleDenominator));
+
+  const tjscalingfactor factor = { 1, scaleDenominator };
+  const auto scaledWidth = TJSCALED(width, factor);
+  const auto scaledHeight = TJSCALED(height, factor);
+
+  auto image = pool_.Acquire(scaledHeight, scaledWidth, CV_8UC3);
+
+  // Corrupt tails of a frame still decode, with a warning
+  if (tjDecompress2(handle_, data, static_cast<unsigned long>(size), image.data,
+    scaledWidth, static_cast<int>(image.step), scaledHeight, TJPF_BGR, TJFLAG_FASTDCT) != 0 &&
+    tjGetErrorCode(handle_) == TJERR_FATAL)
+  {
+    std::cerr << "Failed to decode JPEG: " << tjGetErrorStr2(handle_) << std::endl;
+    return cv::Mat();
+  }
+
+  return image;
+}
+
+cv::Mat JpegDecoder::DecodeI420(const uint8_t* data, size_t size, int scaleDenominator)
+{
+  int width = 0;
+  int height = 0;
+  int subsampling = 0;
+  int colorspace = 0;
+  if (tjDecompressHeader3(handle_, data, static_cast<unsigned long>(size), &width, &height, &subsampling, &colorspace) != 0)
+  {
+    std::cerr << "Failed to read JPEG header: " << tjGetErrorStr2(handle_) << std::endl;
+    return cv::Mat();
+  }
+
+  if (scaleDenominator != 1 && scaleDenominator != 2 && scaleDenominator != 4 && scaleDenominator != 8)
+    throw std::runtime_error("Unsupported JPEG scale denominator: " + std::to_string(scaleDenominator));
+
+  const tjscalingfactor factor = { 1, scaleDenominator };
+  const auto scaledWidth = TJSCALED(width, factor);
+  const auto scaledHeight = TJSCALED(height, factor);
+
+  // I420 has no odd sizes
+  if (scaledWidth % 2 != 0 || scaledHeight % 2 != 0)
+    return Decode(data, size, scaleDenominator);
+
+  auto image = pool_.Acquire(scaledHeight * 3 / 2, scaledWidth, CV_8UC1);
+
+  if (subsampling != TJSAMP_420)
+  {
+    const auto bgr = Decode(data, size, scaleDenominator);
+    if (bgr.empty())
+      return cv::Mat();
+
+    cv::cvtColor(bgr, image, cv::COLOR_BGR2YUV_I420);
+    return image;
+  }
+
+  // Planes written directly into the frame
+  const auto lumaSize = scaledWidth * scaledHeight;
+  const auto chromaSize = lumaSize / 4;
+  unsigned char* planes[3] = { image.data, image.data + lumaSize, image.data + lumaSize + chromaSize };
+  int strides[3] = { scaledWidth, scaledWidth / 2, scaledWidth / 2 };
+
+  if (tjDecompressToYUVPlanes(handle_, data, static_cast<unsigned long>(size), planes,
+    scaledWidth, strides, scaledHeight, TJFLAG_FASTDCT) != 0 &&
+    tjGetErrorCode(handle_) == TJERR_FATAL)
+  {
+    std::cerr << "Failed to decode JPEG: " << tjGetErrorStr2(handle_) << std::endl;
+    return cv::Mat();
+  }
+
+  return image;
+}
+}
+}
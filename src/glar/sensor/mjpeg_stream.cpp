@@ -0,0 +1,332 @@
+#include <glar/sensor/mjpeg_stream.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+#include <glar/util/socket.h>
+
+namespace glar
+{
+namespace sensor
+{
+namespace
+{
+// A stalled stream is reconnected
+constexpr double receiveTimeout = 2.; // 2s
+
+constexpr size_t receiveBufferSize = 64 * 1024;
+constexpr size_t maxLineLength = 8 * 1024;
+
+std::string ToLower(std::string s)
+{
+  std::transform(s.begin(), s.end(), s.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+  return s;
+}
+
+std::string Trim(const std::string& s)
+{
+  const auto begin = s.find_first_not_of(" \t\r\"");
+  if (begin == std::string::npos)
+    return {};
+
+  const auto end = s.find_last_not_of(" \t\r\"");
+  return s.substr(begin, end - begin + 1);
+}
+
+/**
+* Buffered reads of lines and bodies from a socket, throwing when the connection is closed or times out
+*/
+class StreamReader
+{
+public:
+  StreamReader() = delete;
+  explicit StreamReader(util::Socket& socket)
+    : socket_(socket)
+    , buffer_(receiveBufferSize)
+  {
+  }
+
+  // Without the line ending
+  std::string ReadLine()
+  {
+    while (true)
+    {
+      const auto begin = buffer_.begin() + begin_;
+      const auto end = buffer_.begin() + end_;
+      const auto newline = std::find(begin, end, '\n');
+      if (newline != end)
+      {
+        std::string line(begin, newline);
+        begin_ += line.size() + 1;
+
+        if (!line.empty() && line.back() == '\r')
+          line.pop_back();
+        return line;
+      }
+
+      if (end_ - begin_ > maxLineLength)
+        throw std::runtime_error("Too long line in MJPEG stream");
+
+      Fill();
+    }
+  }
+
+  void Read(size_t size, std::vector<uint8_t>& data)
+  {
+    data.resize(size);
+
+    // Buffered bytes first, then the rest directly into data
+    size_t copied = std::min(size, end_ - begin_);
+    std::memcpy(data.data(), buffer_.data() + begin_, copied);
+    begin_ += copied;
+
+    while (copied < size)
+    {
+      const auto received = socket_.Receive(data.data() + copied, size - copied);
+      if (received == 0)
+        throw std::runtime_error("MJPEG stream closed");
+      copied += received;
+    }
+  }
+
+  // Reads up to the delimiter, which is left in the stream
+  void ReadUntil(const std::string& delimiter, std::vector<uint8_t>& data)
+  {
+    data.clear();
+    while (true)
+    {
+      const auto begin = buffer_.begin() + begin_;
+      const auto end = buffer_.begin() + end_;
+      const auto found = std::search(begin, end, delimiter.begin(), delimiter.end());
+      if (found != end)
+      {
+        data.insert(data.end(), begin, found);
+        begin_ += found - begin;
+        return;
+      }
+
+      // Keep a possible partial delimiter at the end
+      const auto available = end_ - begin_;
+      if (available >= delimiter.size())
+      {
+        const auto consumed = available - (delimiter.size() - 1);
+        data.insert(data.end(), begin, begin + consumed);
+        begin_ += consumed;
+      }
+
+      Fill();
+    }
+  }
+
+private:
+  void Fill()
+  {
+    if (begin_ > 0)
+    {
+      std::memmove(buffer_.data(), buffer_.data() + begin_, end_ - begin_);
+      end_ -= begin_;
+      begin_ = 0;
+    }
+
+    if (end_ == buffer_.size())
+      buffer_.resize(buffer_.size() * 2);
+
+    const auto received = socket_.Receive(buffer_.data() + end_, buffer_.size() - end_);
+    if (received == 0)
+      throw std::runtime_error("MJPEG stream closed");
+    end_ += received;
+  }
+
+  util::Socket& socket_;
+
+  std::vector<char> buffer_;
+  size_t begin_ = 0;
+  size_t end_ = 0;
+};
+}
+
+MjpegStream::MjpegStream(const std::string& address, int scaleDenominator, bool i420)
+  : scaleDenominator_(scaleDenominator)
+  , i420_(i420)
+{
+  if (scaleDenominator != 1 && scaleDenominator != 2 && scaleDenominator != 4 && scaleDenominator != 8)
+    throw std::runtime_error("Unsupported JPEG scale denominator: " + std::to_string(scaleDenominator));
+
+  // http://host[:port][/path]
+  auto rest = address;
+  const auto scheme = rest.find("://");
+  if (scheme != std::string::npos)
+  {
+    if (ToLower(rest.substr(0, scheme)) != "http")
+      throw std::runtime_error("Only http is supported for MJPEG streams: " + address);
+    rest = rest.substr(scheme + 3);
+  }
+
+  const auto pathBegin = rest.find('/');
+  auto authority = rest.substr(0, pathBegin);
+  path_ = pathBegin != std::string::npos ? rest.substr(pathBegin) : "";
+  if (!path_.empty() && path_.back() == '/')
+    path_.pop_back();
+  path_ += "/video";
+
+  const auto colon = authority.find(':');
+  if (colon != std::string::npos)
+  {
+    port_ = static_cast<uint16_t>(std::stoi(authority.substr(colon + 1)));
+    authority = authority.substr(0, colon);
+  }
+  host_ = authority;
+
+  receiveThread_ = std::thread([this] { Receive(); });
+  decodeThread_ = std::thread([this] { Decode(); });
+}
+
+MjpegStream::~MjpegStream()
+{
+  Terminate();
+  {
+    std::unique_lock<std::mutex> guard(pendingMutex_);
+    pendingCondition_.notify_all();
+  }
+
+  receiveThread_.join();
+  decodeThread_.join();
+}
+
+void MjpegStream::Receive()
+{
+  while (!Terminating())
+  {
+    try
+    {
+      std::cout << "Opening MJPEG stream" << std::endl;
+      auto socket = util::Socket::Connect(host_, port_);
+      socket->SetTimeout(receiveTimeout);
+
+      ReceiveStream(*socket);
+    }
+    catch (const std::exception& e)
+    {
+      if (Terminating())
+        break;
+
+      std::cout << e.what() << std::endl;
+      if (!WaitReconnect())
+        break;
+    }
+  }
+}
+
+void MjpegStream::ReceiveStream(util::Socket& socket)
+{
+  StreamReader reader(socket);
+
+  // HTTP/1.0 keeps the body unchunked
+  if (!socket.Send("GET " + path_ + " HTTP/1.0\r\nHost: " + host_ + "\r\n\r\n"))
+    throw std::runtime_error("Failed to request MJPEG stream");
+
+  const auto status = reader.ReadLine();
+  if (status.compare(0, 5, "HTTP/") != 0 || status.find(" 200") == std::string::npos)
+    throw std::runtime_error("Unexpected HTTP response: " + status);
+
+  std::string boundary;
+  for (auto line = reader.ReadLine(); !line.empty(); line = reader.ReadLine())
+  {
+    const auto header = ToLower(line);
+    const auto boundaryBegin = header.find("boundary=");
+    if (header.compare(0, 13, "content-type:") == 0 && boundaryBegin != std::string::npos)
+      boundary = Trim(line.substr(boundaryBegin + 9, line.find(';', boundaryBegin) - boundaryBegin - 9));
+  }
+
+  if (boundary.empty())
+    throw std::runtime_error("Not a multipart stream: " + path_);
+
+  // Some servers put the leading dashes of the delimiter into the boundary parameter
+  const auto delimiter = boundary.compare(0, 2, "--") == 0 ? boundary : "--" + boundary;
+  const auto bodyDelimiter = "\r\n" + delimiter;
+
+  std::cout << "MJPEG stream opened: " << host_ << ":" << port_ << path_ << std::endl;
+
+  Opened(0.);
+
+  const auto streamOpenTime = std::chrono::high_resolution_clock::now();
+  uint64_t receivedCount = 0;
+
+  Frame frame;
+  while (!Terminating())
+  {
+    // Preamble and line endings before the next part
+    for (auto line = Trim(reader.ReadLine()); line != delimiter && line != "--" + boundary; line = Trim(reader.ReadLine()))
+    {
+      if (line == delimiter + "--")
+        throw std::runtime_error("MJPEG stream ended");
+    }
+
+    size_t contentLength = 0;
+    bool hasContentLength = false;
+    for (auto line = reader.ReadLine(); !line.empty(); line = reader.ReadLine())
+    {
+      if (ToLower(line).compare(0, 15, "content-length:") == 0)
+      {
+        contentLength = std::stoull(line.substr(15));
+        hasContentLength = true;
+      }
+    }
+
+    const auto readStartTime = std::chrono::high_resolution_clock::now();
+    if (hasContentLength)
+      reader.Read(contentLength, frame.data);
+    else
+      reader.ReadUntil(bodyDelimiter, frame.data);
+
+    frame.receiveTime = std::chrono::high_resolution_clock::now();
+    frame.readTime = std::chrono::duration<double>(frame.receiveTime - readStartTime).count();
+    Publish(frame);
+    receivedCount++;
+
+    // Received rate as the stream rate, decoded frames make the actual rate
+    const auto elapsed = std::chrono::duration<double>(frame.receiveTime - streamOpenTime).count();
+    if (elapsed > 0.)
+      UpdateTargetFps(receivedCount / elapsed);
+  }
+}
+
+void MjpegStream::Publish(Frame& frame)
+{
+  // Swapped, so that buffers are reused and an undecoded older frame is dropped
+  std::unique_lock<std::mutex> guard(pendingMutex_);
+  std::swap(frame, pending_);
+  hasPending_ = true;
+  pendingCondition_.notify_one();
+}
+
+void MjpegStream::Decode()
+{
+  Frame frame;
+  while (true)
+  {
+    {
+      std::unique_lock<std::mutex> guard(pendingMutex_);
+      pendingCondition_.wait(guard, [this] { return hasPending_ || Terminating(); });
+      if (Terminating())
+        return;
+
+      std::swap(frame, pending_);
+      hasPending_ = false;
+    }
+
+    const auto decodeStartTime = std::chrono::high_resolution_clock::now();
+    auto image = i420_
+      ? decoder_.DecodeI420(frame.data.data(), frame.data.size(), scaleDenominator_)
+      : decoder_.Decode(frame.data.data(), frame.data.size(), scaleDenominator_);
+    const auto decodeTime = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - decodeStartTime).count();
+
+    if (!image.empty())
+      UpdateImage(image, frame.receiveTime, frame.readTime, decodeTime);
+  }
+}
+}
+}
@@ -1,6 +1,7 @@
 #include <glar/sensor/video_capture.h>
 
 #include <chrono>
+#include <iostream>
 
 #include <opencv2/core.hpp>
 #include <opencv2/videoio.hpp>
@@ -13,111 +14,69 @@ VideoCapture::VideoCapture(const std::string& address)
 {
   videoStreamAddress_ = address + "/video";
 
-  worker_ = std::thread([&]
+  worker_ = std::thread([this]
     {
       cv::VideoCapture vcap;
       cv::Mat image;
 
-      std::chrono::high_resolution_clock::time_point streamOpenTime;
-
-      bool opened = false;
-      uint64_t frameIndex = 0;
-      while (!terminate_)
+      while (!Terminating())
       {
-        using namespace std::chrono_literals;
-
-        if (!opened)
+        std::cout << "Opening stream" << std::endl;
+        if (!vcap.open(videoStreamAddress_))
         {
-          std::cout << "Opening stream" << std::endl;
-          if (vcap.open(videoStreamAddress_))
-          {
-            const double targetFps = vcap.get(cv::CAP_PROP_FPS);
-
-            // Limit vcap buffer size
-            vcap.set(cv::CAP_PROP_BUFFERSIZE, 2);
-
-            std::cout << "Video stream opened:" << std::endl
-              << "  FPS: " << targetFps << std::endl;
-
-            {
-              std::unique_lock<std::mutex> guard(fpsMutex_);
-              targetFps_ = targetFps;
-            }
-
-            streamOpenTime = std::chrono::high_resolution_clock::now();
-            frameIndex = 0;
-
-            opened = true;
-          }
-          else
-          {
-            std::cout << "Failed to open video stream. Waiting for 1s..." << std::endl;
-            vcap = {};
-            std::this_thread::sleep_for(1s);
-          }
-        }
+          std::cout << "Failed to open video stream" << std::endl;
+          vcap.release();
 
-        if (opened)
-        {
-          const auto currentTime = std::chrono::high_resolution_clock::now();
-          const auto elapsed = std::chrono::duration<double>(currentTime - streamOpenTime).count();
-
-          if (vcap.read(image))
-          {
-            UpdateImage(image);
-            frameIndex++;
-          }
-
-          else
-          {
-            vcap = {};
-            opened = false;
-            frameIndex = 0;
-          }
+          if (!WaitReconnect())
+            break;
+          continue;
         }
 
-        // Update fps
-        const auto currentTime = std::chrono::high_resolution_clock::now();
-        const auto elapsed = std::chrono::duration<double>(currentTime - streamOpenTime).count();
-        const auto fps = frameIndex / elapsed;
+        const double targetFps = vcap.get(cv::CAP_PROP_FPS);
+
+        // Limit vcap buffer size
+        vcap.set(cv::CAP_PROP_BUFFERSIZE, 2);
+
+        std::cout << "Video stream opened:" << std::endl
+          << "  FPS: " << targetFps << std::endl;
+
+        Opened(targetFps);
+
+        // Blocks until the next frame arrives
+        while (!Terminating())
         {
-          std::unique_lock<std::mutex> guard(fpsMutex_);
-          fps_ = fps;
+          const auto readStartTime = std::chrono::high_resolution_clock::now();
+          if (!vcap.grab())
+            break;
+
+          const auto captureTime = std::chrono::high_resolution_clock::now();
+          if (!vcap.retrieve(image))
+            break;
+
+          const auto decodeEndTime = std::chrono::high_resolution_clock::now();
+          UpdateImage(image, captureTime,
+            std::chrono::duration<double>(captureTime - readStartTime).count(),
+            std::chrono::duration<double>(decodeEndTime - captureTime).count());
+
+          // The frame is handed over, so the next one is decoded into a new image instead of overwriting it
+          image = cv::Mat();
         }
+
+        vcap.release();
+        if (Terminating())
+          break;
+
+        std::cout << "Video stream lost" << std::endl;
+        if (!WaitReconnect())
+          break;
       }
     });
 }
 
 VideoCapture::~VideoCapture()
 {
-  terminate_ = true;
+  Terminate();
   worker_.join();
 }
-
-double VideoCapture::TargetFps() const
-{
-  std::unique_lock<std::mutex> guard(fpsMutex_);
-  return targetFps_;
-}
-
-double VideoCapture::Fps() const
-{
-  std::unique_lock<std::mutex> guard(fpsMutex_);
-  return fps_;
-}
-
-cv::Mat VideoCapture::Image()
-{
-  std::unique_lock<std::mutex> guard(mutex_);
-  auto result = image_;
-  image_ = cv::Mat();
-  return result;
-}
-
-void VideoCapture::UpdateImage(cv::Mat image)
-{
-  std::unique_lock<std::mutex> guard(mutex_);
-  image_ = image;
-}
 }
 }
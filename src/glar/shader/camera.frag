@@ -2,10 +2,23 @@
 
 in vec2 fragTexCoord;
 
+// RGB, or the Y plane of I420 frames
 uniform sampler2D tex;
+uniform sampler2D uTex;
+uniform sampler2D vTex;
+uniform bool i420;
 
 out vec4 outColor;
 
 void main() {
-  outColor = vec4(texture(tex, fragTexCoord).rgb, 1.f);
+  if (i420) {
+    // Full range BT.601, as used by JPEG
+    const float y = texture(tex, fragTexCoord).r;
+    const float u = texture(uTex, fragTexCoord).r - 0.5f;
+    const float v = texture(vTex, fragTexCoord).r - 0.5f;
+    const vec3 rgb = vec3(y + 1.402f * v, y - 0.344136f * u - 0.714136f * v, y + 1.772f * u);
+    outColor = vec4(clamp(rgb, 0.f, 1.f), 1.f);
+  }
+  else
+    outColor = vec4(texture(tex, fragTexCoord).rgb, 1.f);
 }
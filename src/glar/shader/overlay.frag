@@ -0,0 +1,61 @@
+#version 430 core
+
+in vec2 fragTexCoord;
+
+// Reduced resolution overlay, cleared to transparent black so that colors are premultiplied by coverage
+uniform sampler2D colorTex;
+uniform sampler2D depthTex;
+uniform vec2 depthRange; // [near, far]
+
+out vec4 outColor;
+
+// Relative depth difference at which a covered texel stops contributing
+const float depthTolerance = 0.05f;
+
+float LinearDepth(float depth) {
+  const float near = depthRange.x;
+  const float far = depthRange.y;
+  return 2.f * near * far / (far + near - (2.f * depth - 1.f) * (far - near));
+}
+
+void main() {
+  // Four nearest overlay texels, and their bilinear weights
+  const ivec2 size = textureSize(colorTex, 0);
+  const vec2 position = fragTexCoord * vec2(size) - 0.5f;
+  const ivec2 base = ivec2(floor(position));
+  const vec2 f = position - vec2(base);
+
+  const ivec2 offsets[4] = ivec2[4](ivec2(0, 0), ivec2(1, 0), ivec2(0, 1), ivec2(1, 1));
+  const float bilinear[4] = float[4]((1.f - f.x) * (1.f - f.y), f.x * (1.f - f.y), (1.f - f.x) * f.y, f.x * f.y);
+
+  vec4 colors[4];
+  float depths[4];
+  float nearestDepth = 1.f;
+  for (int i = 0; i < 4; i++) {
+    const ivec2 texel = clamp(base + offsets[i], ivec2(0), size - 1);
+    colors[i] = texelFetch(colorTex, texel, 0);
+    depths[i] = texelFetch(depthTex, texel, 0).r;
+    if (colors[i].a > 0.f)
+      nearestDepth = min(nearestDepth, depths[i]);
+  }
+
+  if (nearestDepth == 1.f)
+    discard;
+
+  // Covered texels behind the nearest surface are left out, so that a branch in front is not blurred into the one
+  // behind it. Uncovered texels keep their weight, so that silhouettes over the camera image stay smooth.
+  const float nearest = LinearDepth(nearestDepth);
+  vec4 color = vec4(0.f);
+  float weightSum = 0.f;
+  for (int i = 0; i < 4; i++) {
+    float weight = bilinear[i] + 1e-3f;
+    if (colors[i].a > 0.f)
+      weight *= max(1.f - (LinearDepth(depths[i]) - nearest) / (depthTolerance * nearest), 0.f);
+
+    color += weight * colors[i];
+    weightSum += weight;
+  }
+
+  outColor = color / weightSum;
+  gl_FragDepth = nearestDepth;
+}
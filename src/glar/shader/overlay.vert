@@ -0,0 +1,10 @@
+#version 430 core
+
+layout (location = 0) in vec2 position;
+
+out vec2 fragTexCoord;
+
+void main() {
+  gl_Position = vec4(position * 2.f - 1.f, 0.f, 1.f);
+  fragTexCoord = position; // Framebuffer rows are bottom up already
+}
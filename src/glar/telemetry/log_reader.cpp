@@ -0,0 +1,39 @@
+#include <glar/telemetry/log_reader.h>
+
+#include <stdexcept>
+
+namespace glar
+{
+namespace telemetry
+{
+LogReader::LogReader(const std::string& filepath)
+  : in_(filepath, std::ios::binary)
+{
+  if (!in_)
+    throw std::runtime_error("Failed to open telemetry log: " + filepath);
+
+  in_.read(reinterpret_cast<char*>(&header_), sizeof(FileHeader));
+  if (!in_ || std::memcmp(header_.magic, logMagic, sizeof(logMagic)) != 0)
+    throw std::runtime_error("Not a telemetry log: " + filepath);
+
+  if (header_.version > logVersion)
+    throw std::runtime_error("Unsupported telemetry log version " + std::to_string(header_.version) + ": " + filepath);
+
+  // Fields appended to the header later are skipped
+  if (header_.headerSize < sizeof(FileHeader))
+    throw std::runtime_error("Invalid telemetry log header: " + filepath);
+  in_.seekg(header_.headerSize);
+}
+
+bool LogReader::Next(RecordHeader& header)
+{
+  in_.read(reinterpret_cast<char*>(&header), sizeof(RecordHeader));
+  if (in_.gcount() != sizeof(RecordHeader))
+    return false;
+
+  data_.resize(header.size);
+  in_.read(data_.data(), header.size);
+  return in_.gcount() == header.size;
+}
+}
+}
@@ -0,0 +1,109 @@
+#include <glar/telemetry/log_writer.h>
+
+#include <stdexcept>
+#include <vector>
+
+namespace glar
+{
+namespace telemetry
+{
+namespace
+{
+// Records are collected up to this size before a write
+constexpr size_t batchSize = 256 * 1024;
+}
+
+LogWriter::LogWriter(const CreateInfo& createInfo)
+  : createInfo_(createInfo)
+  , startTime_(Clock::now())
+  , out_(createInfo.filepath, std::ios::binary)
+  , queue_(createInfo.queueCapacity)
+{
+  if (!out_)
+    throw std::runtime_error("Failed to open telemetry log for writing: " + createInfo.filepath);
+
+  FileHeader header = {};
+  std::memcpy(header.magic, logMagic, sizeof(logMagic));
+  header.version = logVersion;
+  header.headerSize = sizeof(FileHeader);
+  header.startTime = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+  out_.write(reinterpret_cast<const char*>(&header), sizeof(FileHeader));
+
+  thread_ = std::thread([this] { Run(); });
+}
+
+LogWriter::~LogWriter()
+{
+  {
+    std::unique_lock<std::mutex> guard(mutex_);
+    terminate_ = true;
+  }
+  condition_.notify_one();
+
+  thread_.join();
+}
+
+LogWriter::Stats LogWriter::stats() const
+{
+  Stats stats;
+  stats.queuedCount = queuedCount_;
+  stats.droppedCount = droppedCount_;
+  stats.writtenCount = writtenCount_.load(std::memory_order_relaxed);
+  stats.writtenBytes = writtenBytes_.load(std::memory_order_relaxed);
+  return stats;
+}
+
+void LogWriter::Run()
+{
+  std::vector<char> batch;
+  batch.reserve(batchSize + sizeof(QueuedRecord));
+  uint64_t batchCount = 0;
+
+  const auto flush = [&]()
+  {
+    if (batch.empty())
+      return;
+
+    out_.write(batch.data(), batch.size());
+    out_.flush();
+
+    writtenCount_.fetch_add(batchCount, std::memory_order_relaxed);
+    writtenBytes_.fetch_add(batch.size(), std::memory_order_relaxed);
+    batch.clear();
+    batchCount = 0;
+  };
+
+  const auto flushInterval = std::chrono::duration<double>(createInfo_.flushInterval);
+
+  QueuedRecord record;
+  std::unique_lock<std::mutex> guard(mutex_);
+  while (true)
+  {
+    // The producer doesn't notify, so that queueing stays a plain store
+    condition_.wait_for(guard, flushInterval, [this] { return terminate_; });
+    const auto terminating = terminate_;
+    guard.unlock();
+
+    // The last records are queued before termination, by the thread destroying the writer
+    while (queue_.TryPop(record))
+    {
+      const auto size = sizeof(RecordHeader) + record.header.size;
+      const auto offset = batch.size();
+      batch.resize(offset + size);
+      std::memcpy(batch.data() + offset, &record.header, sizeof(RecordHeader));
+      std::memcpy(batch.data() + offset + sizeof(RecordHeader), record.data, record.header.size);
+      batchCount++;
+
+      if (batch.size() >= batchSize)
+        flush();
+    }
+    flush();
+
+    if (terminating)
+      return;
+
+    guard.lock();
+  }
+}
+}
+}
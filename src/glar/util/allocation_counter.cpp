@@ -0,0 +1,78 @@
+#include <glar/util/allocation_counter.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace glar
+{
+namespace util
+{
+namespace
+{
+std::atomic_bool countingEnabled = false;
+
+std::atomic<uint64_t> totalCount = 0;
+std::atomic<uint64_t> totalBytes = 0;
+
+// Plain data, so it needs no construction on first use inside operator new
+thread_local AllocationCounts threadCounts;
+}
+
+void AllocationCounter::SetEnabled(bool enabled)
+{
+  countingEnabled = enabled;
+}
+
+bool AllocationCounter::Enabled()
+{
+  return countingEnabled;
+}
+
+AllocationCounts AllocationCounter::ThreadCounts()
+{
+  return threadCounts;
+}
+
+AllocationCounts AllocationCounter::TotalCounts()
+{
+  return { totalCount.load(std::memory_order_relaxed), totalBytes.load(std::memory_order_relaxed) };
+}
+
+void AllocationCounter::Record(size_t bytes)
+{
+  if (!countingEnabled.load(std::memory_order_relaxed))
+    return;
+
+  threadCounts.count++;
+  threadCounts.bytes += bytes;
+  totalCount.fetch_add(1, std::memory_order_relaxed);
+  totalBytes.fetch_add(bytes, std::memory_order_relaxed);
+}
+}
+}
+
+// The other forms of new and delete default to these two
+void* operator new(std::size_t size)
+{
+  glar::util::AllocationCounter::Record(size);
+
+  if (size == 0)
+    size = 1;
+
+  while (true)
+  {
+    if (auto pointer = std::malloc(size))
+      return pointer;
+
+    const auto handler = std::get_new_handler();
+    if (handler == nullptr)
+      throw std::bad_alloc();
+    handler();
+  }
+}
+
+void operator delete(void* pointer) noexcept
+{
+  std::free(pointer);
+}
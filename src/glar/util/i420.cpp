@@ -0,0 +1,26 @@
+#include <glar/util/i420.h>
+
+namespace glar
+{
+namespace util
+{
+bool IsI420(const cv::Mat& frame)
+{
+  return frame.type() == CV_8UC1;
+}
+
+cv::Size FrameSize(const cv::Mat& frame)
+{
+  if (IsI420(frame))
+    return cv::Size(frame.cols, frame.rows * 2 / 3);
+  return frame.size();
+}
+
+cv::Mat DetectionImage(const cv::Mat& frame)
+{
+  if (IsI420(frame))
+    return frame.rowRange(0, frame.rows * 2 / 3);
+  return frame;
+}
+}
+}
@@ -0,0 +1,87 @@
+#include <glar/util/mapped_file.h>
+
+#include <stdexcept>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace glar
+{
+namespace util
+{
+#ifdef _WIN32
+MappedFile::MappedFile(const std::string& filepath)
+{
+  file_ = CreateFileA(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+  if (file_ == INVALID_HANDLE_VALUE)
+    throw std::runtime_error("Failed to open file: " + filepath);
+
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(file_, &size) || size.QuadPart == 0)
+  {
+    CloseHandle(file_);
+    throw std::runtime_error("Failed to map empty file: " + filepath);
+  }
+  size_ = static_cast<size_t>(size.QuadPart);
+
+  mapping_ = CreateFileMappingA(file_, NULL, PAGE_READONLY, 0, 0, NULL);
+  if (mapping_ == NULL)
+  {
+    CloseHandle(file_);
+    throw std::runtime_error("Failed to create file mapping: " + filepath);
+  }
+
+  data_ = MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0);
+  if (data_ == NULL)
+  {
+    CloseHandle(mapping_);
+    CloseHandle(file_);
+    throw std::runtime_error("Failed to map file: " + filepath);
+  }
+}
+
+MappedFile::~MappedFile()
+{
+  UnmapViewOfFile(data_);
+  CloseHandle(mapping_);
+  CloseHandle(file_);
+}
+#else
+MappedFile::MappedFile(const std::string& filepath)
+{
+  file_ = open(filepath.c_str(), O_RDONLY);
+  if (file_ < 0)
+    throw std::runtime_error("Failed to open file: " + filepath);
+
+  struct stat status;
+  if (fstat(file_, &status) != 0 || status.st_size == 0)
+  {
+    close(file_);
+    throw std::runtime_error("Failed to map empty file: " + filepath);
+  }
+  size_ = static_cast<size_t>(status.st_size);
+
+  data_ = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, file_, 0);
+  if (data_ == MAP_FAILED)
+  {
+    close(file_);
+    throw std::runtime_error("Failed to map file: " + filepath);
+  }
+}
+
+MappedFile::~MappedFile()
+{
+  munmap(data_, size_);
+  close(file_);
+}
+#endif
+}
+}
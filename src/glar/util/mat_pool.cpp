@@ -0,0 +1,50 @@
+#include <glar/util/mat_pool.h>
+
+namespace glar
+{
+namespace util
+{
+MatPool::MatPool(int capacity)
+  : capacity_(capacity)
+{
+  images_.reserve(capacity);
+}
+
+MatPool::~MatPool() = default;
+
+bool MatPool::Free(const cv::Mat& image)
+{
+  // Only the pool holds a reference. Read atomically, as other threads may be releasing theirs.
+  return image.u != nullptr && CV_XADD(&image.u->refcount, 0) == 1;
+}
+
+cv::Mat MatPool::Acquire(int rows, int cols, int type)
+{
+  cv::Mat* replaceable = nullptr;
+  for (auto& image : images_)
+  {
+    if (!Free(image))
+      continue;
+
+    if (image.rows == rows && image.cols == cols && image.type() == type)
+    {
+      stats_.reuseCount++;
+      return image;
+    }
+
+    replaceable = &image;
+  }
+
+  stats_.allocationCount++;
+  cv::Mat image(rows, cols, type);
+
+  // A free image of another size makes room, otherwise the pool grows up to its capacity
+  if (replaceable != nullptr)
+    *replaceable = image;
+  else if (images_.size() < capacity_)
+    images_.push_back(image);
+
+  return image;
+}
+}
+}
@@ -0,0 +1,150 @@
+#include <glar/util/pooled_mat_allocator.h>
+
+#include <new>
+
+#include <glar/util/allocation_counter.h>
+
+namespace glar
+{
+namespace util
+{
+namespace
+{
+// Detector images of a 160x120 frame and up, camera parameters and corner lists stay on the heap
+constexpr size_t defaultMinPooledSize = 16 * 1024;
+constexpr size_t defaultMaxPooledBytes = 256 * 1024 * 1024;
+}
+
+PooledMatAllocator::PooledMatAllocator(size_t minPooledSize, size_t maxPooledBytes)
+  : minPooledSize_(minPooledSize)
+  , maxPooledBytes_(maxPooledBytes)
+{
+}
+
+PooledMatAllocator::~PooledMatAllocator()
+{
+  for (const auto& sizeBuffers : buffers_)
+  {
+    for (auto buffer : sizeBuffers.second)
+      cv::fastFree(buffer);
+  }
+
+  for (auto record : records_)
+    ::operator delete(record);
+}
+
+PooledMatAllocator& PooledMatAllocator::InstallDefault()
+{
+  static auto allocator = new PooledMatAllocator(defaultMinPooledSize, defaultMaxPooledBytes);
+  cv::Mat::setDefaultAllocator(allocator);
+  return *allocator;
+}
+
+PooledMatAllocator::Stats PooledMatAllocator::stats() const
+{
+  std::unique_lock<std::mutex> guard(mutex_);
+  return stats_;
+}
+
+cv::UMatData* PooledMatAllocator::allocate(int dims, const int* sizes, int type, void* data, size_t* step,
+  cv::AccessFlag flags, cv::UMatUsageFlags usageFlags) const
+{
+  // Same layout as the standard allocator
+  size_t total = CV_ELEM_SIZE(type);
+  for (int i = dims - 1; i >= 0; i--)
+  {
+    if (step)
+    {
+      if (data && step[i] != CV_AUTOSTEP)
+      {
+        CV_Assert(total <= step[i]);
+        total = step[i];
+      }
+      else
+        step[i] = total;
+    }
+    total *= sizes[i];
+  }
+
+  void* record;
+  {
+    std::unique_lock<std::mutex> guard(mutex_);
+    if (!records_.empty())
+    {
+      record = records_.back();
+      records_.pop_back();
+    }
+    else
+      record = nullptr;
+  }
+  if (record == nullptr)
+    record = ::operator new(sizeof(cv::UMatData));
+
+  auto u = new (record) cv::UMatData(this);
+  u->data = u->origdata = static_cast<uchar*>(data ? data : AllocateBuffer(total));
+  u->size = total;
+  if (data)
+    u->flags |= cv::UMatData::USER_ALLOCATED;
+  return u;
+}
+
+bool PooledMatAllocator::allocate(cv::UMatData* data, cv::AccessFlag accessFlags, cv::UMatUsageFlags usageFlags) const
+{
+  return data != nullptr;
+}
+
+void PooledMatAllocator::deallocate(cv::UMatData* data) const
+{
+  if (data == nullptr)
+    return;
+
+  CV_Assert(data->urefcount == 0);
+  CV_Assert(data->refcount == 0);
+
+  if (!(data->flags & cv::UMatData::USER_ALLOCATED))
+    FreeBuffer(data->origdata, data->size);
+
+  data->~UMatData();
+
+  std::unique_lock<std::mutex> guard(mutex_);
+  records_.push_back(data);
+}
+
+void* PooledMatAllocator::AllocateBuffer(size_t size) const
+{
+  if (size >= minPooledSize_)
+  {
+    std::unique_lock<std::mutex> guard(mutex_);
+    auto it = buffers_.find(size);
+    if (it != buffers_.end() && !it->second.empty())
+    {
+      auto buffer = it->second.back();
+      it->second.pop_back();
+      stats_.pooledBytes -= size;
+      stats_.reuseCount++;
+      return buffer;
+    }
+    stats_.allocationCount++;
+  }
+
+  AllocationCounter::Record(size);
+  return cv::fastMalloc(size);
+}
+
+void PooledMatAllocator::FreeBuffer(void* buffer, size_t size) const
+{
+  if (size >= minPooledSize_)
+  {
+    std::unique_lock<std::mutex> guard(mutex_);
+    if (stats_.pooledBytes + size <= maxPooledBytes_)
+    {
+      buffers_[size].push_back(buffer);
+      stats_.pooledBytes += size;
+      return;
+    }
+  }
+
+  cv::fastFree(buffer);
+}
+}
+}
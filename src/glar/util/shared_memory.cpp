@@ -0,0 +1,137 @@
+#include <glar/util/shared_memory.h>
+
+#include <cstring>
+#include <stdexcept>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace glar
+{
+namespace util
+{
+std::unique_ptr<SharedMemory> SharedMemory::Create(const std::string& name, size_t size)
+{
+  return std::unique_ptr<SharedMemory>(new SharedMemory(name, size, true));
+}
+
+std::unique_ptr<SharedMemory> SharedMemory::Open(const std::string& name)
+{
+  return std::unique_ptr<SharedMemory>(new SharedMemory(name, 0, false));
+}
+
+#ifdef _WIN32
+SharedMemory::SharedMemory(const std::string& name, size_t size, bool create)
+  : name_("Local\\" + name)
+  , created_(create)
+{
+  if (create)
+  {
+    const auto size64 = static_cast<uint64_t>(size);
+    mapping_ = CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE,
+      static_cast<DWORD>(size64 >> 32), static_cast<DWORD>(size64), name_.c_str());
+  }
+  else
+    mapping_ = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, name_.c_str());
+
+  if (mapping_ == NULL)
+    throw std::runtime_error("Failed to " + std::string(create ? "create" : "open") + " shared memory: " + name);
+
+  // An existing mapping of the same name is reused by Windows, so it is cleared like a new one
+  const auto existed = create && GetLastError() == ERROR_ALREADY_EXISTS;
+
+  data_ = MapViewOfFile(mapping_, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+  if (data_ == NULL)
+  {
+    CloseHandle(mapping_);
+    throw std::runtime_error("Failed to map shared memory: " + name);
+  }
+
+  MEMORY_BASIC_INFORMATION info;
+  VirtualQuery(data_, &info, sizeof(info));
+  size_ = create ? size : static_cast<size_t>(info.RegionSize);
+
+  if (existed)
+  {
+    if (info.RegionSize < size)
+    {
+      UnmapViewOfFile(data_);
+      CloseHandle(mapping_);
+      throw std::runtime_error("Shared memory is still open with a smaller size: " + name);
+    }
+    std::memset(data_, 0, size_);
+  }
+}
+
+SharedMemory::~SharedMemory()
+{
+  UnmapViewOfFile(data_);
+  CloseHandle(mapping_);
+}
+#else
+SharedMemory::SharedMemory(const std::string& name, size_t size, bool create)
+  : name_("/" + name)
+  , created_(create)
+{
+  if (create)
+  {
+    // Readers of a region left over keep their mapping of it, and see the new one after reopening
+    shm_unlink(name_.c_str());
+    file_ = shm_open(name_.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+  }
+  else
+    file_ = shm_open(name_.c_str(), O_RDWR, 0);
+
+  if (file_ < 0)
+    throw std::runtime_error("Failed to " + std::string(create ? "create" : "open") + " shared memory: " + name);
+
+  if (create)
+  {
+    if (ftruncate(file_, static_cast<off_t>(size)) != 0)
+    {
+      close(file_);
+      shm_unlink(name_.c_str());
+      throw std::runtime_error("Failed to size shared memory: " + name);
+    }
+    size_ = size;
+  }
+  else
+  {
+    struct stat status;
+    if (fstat(file_, &status) != 0 || status.st_size == 0)
+    {
+      close(file_);
+      throw std::runtime_error("Failed to open empty shared memory: " + name);
+    }
+    size_ = static_cast<size_t>(status.st_size);
+  }
+
+  data_ = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, file_, 0);
+  if (data_ == MAP_FAILED)
+  {
+    close(file_);
+    if (create)
+      shm_unlink(name_.c_str());
+    throw std::runtime_error("Failed to map shared memory: " + name);
+  }
+}
+
+SharedMemory::~SharedMemory()
+{
+  munmap(data_, size_);
+  close(file_);
+
+  if (created_)
+    shm_unlink(name_.c_str());
+}
+#endif
+}
+}
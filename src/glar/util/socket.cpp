@@ -0,0 +1,188 @@
+#include <glar/util/socket.h>
+
+#include <stdexcept>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <WinSock2.h>
+#include <WS2tcpip.h>
+#pragma comment(lib, "Ws2_32.lib")
+#else
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#endif
+
+namespace glar
+{
+namespace util
+{
+namespace
+{
+#ifdef _WIN32
+constexpr auto invalidHandle = INVALID_SOCKET;
+
+void Close(SOCKET handle)
+{
+  closesocket(handle);
+}
+
+void InitializeSockets()
+{
+  // Winsock is started once and never cleaned up
+  static const bool initialized = []
+  {
+    WSADATA data;
+    if (WSAStartup(MAKEWORD(2, 2), &data) != 0)
+      throw std::runtime_error("Failed to initialize Winsock");
+    return true;
+  }();
+}
+#else
+constexpr auto invalidHandle = -1;
+
+void Close(int handle)
+{
+  close(handle);
+}
+
+void InitializeSockets()
+{
+}
+#endif
+}
+
+Socket::Socket(Handle handle)
+  : handle_(handle)
+{
+}
+
+Socket::~Socket()
+{
+  Close(handle_);
+}
+
+std::unique_ptr<Socket> Socket::Connect(const std::string& host, uint16_t port)
+{
+  InitializeSockets();
+
+  addrinfo hints = {};
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  hints.ai_protocol = IPPROTO_TCP;
+
+  addrinfo* addresses = nullptr;
+  if (getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &addresses) != 0)
+    throw std::runtime_error("Failed to resolve host: " + host);
+
+  // First address that accepts the connection
+  auto handle = invalidHandle;
+  for (auto address = addresses; address != nullptr && handle == invalidHandle; address = address->ai_next)
+  {
+    handle = socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+    if (handle == invalidHandle)
+      continue;
+
+    if (connect(handle, address->ai_addr, static_cast<int>(address->ai_addrlen)) != 0)
+    {
+      Close(handle);
+      handle = invalidHandle;
+    }
+  }
+  freeaddrinfo(addresses);
+
+  if (handle == invalidHandle)
+    throw std::runtime_error("Failed to connect to " + host + ":" + std::to_string(port));
+
+  // Requests are small and should leave immediately
+  int noDelay = 1;
+  setsockopt(handle, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&noDelay), sizeof(noDelay));
+
+  return std::unique_ptr<Socket>(new Socket(handle));
+}
+
+std::unique_ptr<Socket> Socket::Listen(uint16_t port)
+{
+  InitializeSockets();
+
+  const auto handle = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+  if (handle == invalidHandle)
+    throw std::runtime_error("Failed to create socket");
+
+  int reuse = 1;
+  setsockopt(handle, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&reuse), sizeof(reuse));
+
+  sockaddr_in address = {};
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_ANY);
+  address.sin_port = htons(port);
+
+  if (bind(handle, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 || listen(handle, SOMAXCONN) != 0)
+  {
+    Close(handle);
+    throw std::runtime_error("Failed to listen on port " + std::to_string(port));
+  }
+
+  return std::unique_ptr<Socket>(new Socket(handle));
+}
+
+std::unique_ptr<Socket> Socket::Accept()
+{
+  const auto handle = accept(handle_, nullptr, nullptr);
+  if (handle == invalidHandle)
+    return nullptr;
+
+  return std::unique_ptr<Socket>(new Socket(handle));
+}
+
+void Socket::SetTimeout(double seconds)
+{
+#ifdef _WIN32
+  const DWORD timeout = static_cast<DWORD>(seconds * 1000.);
+#else
+  timeval timeout;
+  timeout.tv_sec = static_cast<time_t>(seconds);
+  timeout.tv_usec = static_cast<suseconds_t>((seconds - timeout.tv_sec) * 1000000.);
+#endif
+
+  setsockopt(handle_, SOL_SOCKET, SO_RCVTIMEO, reinterpret_cast<const char*>(&timeout), sizeof(timeout));
+  setsockopt(handle_, SOL_SOCKET, SO_SNDTIMEO, reinterpret_cast<const char*>(&timeout), sizeof(timeout));
+}
+
+size_t Socket::Receive(void* data, size_t size)
+{
+  const auto received = recv(handle_, static_cast<char*>(data), static_cast<int>(size), 0);
+  return received > 0 ? static_cast<size_t>(received) : 0;
+}
+
+bool Socket::Send(const void* data, size_t size)
+{
+#ifdef MSG_NOSIGNAL
+  constexpr int flags = MSG_NOSIGNAL;
+#else
+  constexpr int flags = 0;
+#endif
+
+  auto bytes = static_cast<const char*>(data);
+  while (size > 0)
+  {
+    const auto sent = send(handle_, bytes, static_cast<int>(size), flags);
+    if (sent <= 0)
+      return false;
+
+    bytes += sent;
+    size -= sent;
+  }
+  return true;
+}
+
+bool Socket::Send(const std::string& data)
+{
+  return Send(data.data(), data.size());
+}
+}
+}
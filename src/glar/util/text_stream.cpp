@@ -0,0 +1,63 @@
+#include <glar/util/text_stream.h>
+
+namespace glar
+{
+namespace util
+{
+namespace
+{
+constexpr size_t initialSize = 1024;
+}
+
+TextStream::TextStream()
+  : std::ostream(&buffer_)
+{
+}
+
+TextStream::~TextStream() = default;
+
+void TextStream::Clear()
+{
+  buffer_.Clear();
+  clear();
+}
+
+const char* TextStream::c_str()
+{
+  return buffer_.c_str();
+}
+
+TextStream::Buffer::Buffer()
+  : data_(initialSize)
+{
+  Clear();
+}
+
+void TextStream::Buffer::Clear()
+{
+  // Last byte is kept for the null terminator
+  setp(data_.data(), data_.data() + data_.size() - 1);
+}
+
+const char* TextStream::Buffer::c_str()
+{
+  *pptr() = '\0';
+  return data_.data();
+}
+
+TextStream::Buffer::int_type TextStream::Buffer::overflow(int_type c)
+{
+  if (traits_type::eq_int_type(c, traits_type::eof()))
+    return traits_type::not_eof(c);
+
+  const auto length = pptr() - pbase();
+  data_.resize(data_.size() * 2);
+  setp(data_.data(), data_.data() + data_.size() - 1);
+  pbump(static_cast<int>(length));
+
+  *pptr() = traits_type::to_char_type(c);
+  pbump(1);
+  return c;
+}
+}
+}
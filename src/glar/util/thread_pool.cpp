@@ -0,0 +1,75 @@
+#include <glar/util/thread_pool.h>
+
+#include <algorithm>
+
+namespace glar
+{
+namespace util
+{
+ThreadPool::ThreadPool(int workerCount)
+{
+  workerCount = std::max(workerCount, 1);
+
+  workers_.reserve(workerCount);
+  for (int i = 0; i < workerCount; i++)
+    workers_.emplace_back([this] { Work(); });
+}
+
+ThreadPool::~ThreadPool()
+{
+  {
+    std::unique_lock<std::mutex> guard(mutex_);
+    terminate_ = true;
+  }
+  taskCondition_.notify_all();
+
+  for (auto& worker : workers_)
+    worker.join();
+}
+
+void ThreadPool::Enqueue(std::function<void()> task)
+{
+  {
+    std::unique_lock<std::mutex> guard(mutex_);
+    tasks_.push_back(std::move(task));
+  }
+  taskCondition_.notify_one();
+}
+
+void ThreadPool::Wait()
+{
+  std::unique_lock<std::mutex> guard(mutex_);
+  idleCondition_.wait(guard, [this] { return tasks_.empty() && runningTaskCount_ == 0; });
+}
+
+void ThreadPool::Work()
+{
+  while (true)
+  {
+    std::function<void()> task;
+
+    {
+      std::unique_lock<std::mutex> guard(mutex_);
+      taskCondition_.wait(guard, [this] { return terminate_ || !tasks_.empty(); });
+
+      // Remaining tasks are finished before terminating
+      if (tasks_.empty())
+        return;
+
+      task = std::move(tasks_.front());
+      tasks_.pop_front();
+      runningTaskCount_++;
+    }
+
+    task();
+
+    {
+      std::unique_lock<std::mutex> guard(mutex_);
+      runningTaskCount_--;
+      if (tasks_.empty() && runningTaskCount_ == 0)
+        idleCondition_.notify_all();
+    }
+  }
+}
+}
+}
@@ -0,0 +1,303 @@
+#include <glar/vision/detection_scheduler.h>
+
+#include <algorithm>
+
+#include <glar/util/i420.h>
+
+namespace glar
+{
+namespace vision
+{
+namespace
+{
+// Weight of a new sample in exponential moving averages
+constexpr double averageWeight = 0.1;
+}
+
+DetectionScheduler::DetectionScheduler(MarkerDetector& detector, int workerCount)
+  : detector_(detector)
+  , pool_(workerCount)
+{
+}
+
+DetectionScheduler::~DetectionScheduler()
+{
+  std::unique_lock<std::mutex> guard(mutex_);
+  streams_.clear();
+  idleCondition_.wait(guard, [this] { return runningCount_ == 0; });
+}
+
+int DetectionScheduler::AddStream()
+{
+  std::unique_lock<std::mutex> guard(mutex_);
+  const auto stream = nextStreamId_++;
+  streams_[stream] = Stream();
+  streams_[stream].poseSolver = PoseSolver::Create(poseSolverType_, detector_.MarkerSize());
+  if (tracking_)
+    streams_[stream].tracker = std::make_shared<MarkerTracker>(detector_, trackerCreateInfo_);
+  return stream;
+}
+
+void DetectionScheduler::RemoveStream(int stream)
+{
+  // A running detection of the removed stream drops its result on completion
+  std::unique_lock<std::mutex> guard(mutex_);
+  streams_.erase(stream);
+}
+
+void DetectionScheduler::Submit(int stream, cv::Mat image, Clock::time_point captureTime)
+{
+  std::unique_lock<std::mutex> guard(mutex_);
+
+  auto it = streams_.find(stream);
+  if (it == streams_.end())
+    return;
+
+  auto& s = it->second;
+  s.stats.submittedFrames++;
+  if (s.hasPending)
+    s.stats.droppedFrames++;
+
+  s.hasPending = true;
+  s.pendingImage = image;
+  s.pendingCaptureTime = captureTime;
+
+  Dispatch();
+}
+
+bool DetectionScheduler::TakeResult(int stream, Result& result)
+{
+  std::unique_lock<std::mutex> guard(mutex_);
+
+  auto it = streams_.find(stream);
+  if (it == streams_.end() || !it->second.hasResult)
+    return false;
+
+  // The frame of the caller's previous result is released
+  std::swap(result, it->second.result);
+  it->second.result.image = cv::Mat();
+  it->second.hasResult = false;
+  return true;
+}
+
+DetectionScheduler::StreamStats DetectionScheduler::Stats(int stream) const
+{
+  std::unique_lock<std::mutex> guard(mutex_);
+
+  auto it = streams_.find(stream);
+  if (it == streams_.end())
+    return {};
+
+  uint64_t totalProcessedFrames = 0;
+  for (const auto& s : streams_)
+    totalProcessedFrames += s.second.stats.processedFrames;
+
+  auto stats = it->second.stats;
+  if (totalProcessedFrames > 0)
+    stats.share = static_cast<double>(stats.processedFrames) / totalProcessedFrames;
+  return stats;
+}
+
+PoseSolverStats DetectionScheduler::PoseStats(int stream) const
+{
+  std::unique_lock<std::mutex> guard(mutex_);
+
+  auto it = streams_.find(stream);
+  if (it == streams_.end())
+    return {};
+
+  return it->second.poseSolver->Stats();
+}
+
+MarkerTrackerStats DetectionScheduler::TrackerStats(int stream) const
+{
+  std::unique_lock<std::mutex> guard(mutex_);
+
+  auto it = streams_.find(stream);
+  if (it == streams_.end() || !it->second.tracker)
+    return {};
+
+  return it->second.tracker->Stats();
+}
+
+double DetectionScheduler::FairnessIndex() const
+{
+  std::unique_lock<std::mutex> guard(mutex_);
+
+  double sum = 0.;
+  double squareSum = 0.;
+  for (const auto& s : streams_)
+  {
+    const double x = static_cast<double>(s.second.stats.processedFrames);
+    sum += x;
+    squareSum += x * x;
+  }
+
+  if (squareSum == 0.)
+    return 1.;
+  return sum * sum / (streams_.size() * squareSum);
+}
+
+util::AllocationCounts DetectionScheduler::Allocations() const
+{
+  std::unique_lock<std::mutex> guard(mutex_);
+  return allocations_;
+}
+
+void DetectionScheduler::SetCameraParameters(cv::Mat cameraMatrix, cv::Mat distortion)
+{
+  std::unique_lock<std::mutex> guard(mutex_);
+  paused_ = true;
+  idleCondition_.wait(guard, [this] { return runningCount_ == 0; });
+
+  detector_.SetCameraParameters(cameraMatrix, distortion);
+
+  paused_ = false;
+  Dispatch();
+}
+
+void DetectionScheduler::SetPoseSolver(PoseSolver::Type type)
+{
+  std::unique_lock<std::mutex> guard(mutex_);
+
+  poseSolverType_ = type;
+  for (auto& s : streams_)
+    s.second.poseSolver = PoseSolver::Create(type, detector_.MarkerSize());
+}
+
+PoseSolver::Type DetectionScheduler::PoseSolverType() const
+{
+  std::unique_lock<std::mutex> guard(mutex_);
+  return poseSolverType_;
+}
+
+void DetectionScheduler::SetTracking(bool enabled, const MarkerTracker::CreateInfo& createInfo)
+{
+  std::unique_lock<std::mutex> guard(mutex_);
+
+  tracking_ = enabled;
+  trackerCreateInfo_ = createInfo;
+  for (auto& s : streams_)
+    s.second.tracker = enabled ? std::make_shared<MarkerTracker>(detector_, createInfo) : nullptr;
+}
+
+void DetectionScheduler::Dispatch()
+{
+  if (paused_ || streams_.empty())
+    return;
+
+  while (runningCount_ < pool_.WorkerCount())
+  {
+    // Round-robin from the stream after the last dispatched one
+    auto it = streams_.lower_bound(nextDispatchStream_);
+    Stream* selected = nullptr;
+    int selectedId = 0;
+    for (int i = 0; i < streams_.size(); i++)
+    {
+      if (it == streams_.end())
+        it = streams_.begin();
+
+      if (it->second.hasPending && !it->second.busy)
+      {
+        selected = &it->second;
+        selectedId = it->first;
+        break;
+      }
+
+      ++it;
+    }
+
+    if (selected == nullptr)
+      return;
+
+    selected->busy = true;
+    selected->hasPending = false;
+    auto image = std::move(selected->pendingImage);
+    const auto captureTime = selected->pendingCaptureTime;
+    selected->pendingImage = cv::Mat();
+
+    nextDispatchStream_ = selectedId + 1;
+    runningCount_++;
+
+    auto poseSolver = selected->poseSolver;
+    auto tracker = selected->tracker;
+    pool_.Enqueue([this, selectedId, image, captureTime, poseSolver, tracker]
+    {
+      Detect(selectedId, image, captureTime, poseSolver, tracker);
+    });
+  }
+}
+
+void DetectionScheduler::Detect(int stream, cv::Mat image, Clock::time_point captureTime,
+  std::shared_ptr<PoseSolver> poseSolver, std::shared_ptr<MarkerTracker> tracker)
+{
+  const auto startTime = Clock::now();
+  const auto allocationStartCounts = util::AllocationCounter::ThreadCounts();
+
+  // Vectors of an earlier result keep their capacity
+  Result result;
+  {
+    std::unique_lock<std::mutex> guard(mutex_);
+    auto it = streams_.find(stream);
+    if (it != streams_.end())
+      std::swap(result, it->second.spareResult);
+  }
+
+  result.image = image;
+  result.captureTime = captureTime;
+
+  // Y plane of I420 frames is the grayscale image the detector would convert to
+  const auto detectionImage = util::DetectionImage(image);
+  if (tracker)
+    tracker->Track(detectionImage, result.detection, *poseSolver);
+  else
+    detector_.Detect(detectionImage, result.detection, *poseSolver);
+
+  const auto endTime = Clock::now();
+  const auto allocationCounts = util::AllocationCounter::ThreadCounts() - allocationStartCounts;
+
+  result.detectionStartTime = startTime;
+  result.detectionEndTime = endTime;
+
+  std::unique_lock<std::mutex> guard(mutex_);
+  runningCount_--;
+  allocations_.count += allocationCounts.count;
+  allocations_.bytes += allocationCounts.bytes;
+
+  auto it = streams_.find(stream);
+  if (it != streams_.end())
+  {
+    auto& s = it->second;
+    s.busy = false;
+    s.hasResult = true;
+
+    // A result not taken yet is dropped, and its buffers are kept for the next detection
+    std::swap(s.result, result);
+    std::swap(s.spareResult, result);
+    s.spareResult.image = cv::Mat();
+
+    const auto latency = std::chrono::duration<double>(endTime - captureTime).count();
+    const auto detectionTime = std::chrono::duration<double>(endTime - startTime).count();
+
+    auto& stats = s.stats;
+    if (stats.processedFrames == 0)
+    {
+      stats.averageLatency = latency;
+      stats.averageDetectionTime = detectionTime;
+    }
+    else
+    {
+      stats.averageLatency += averageWeight * (latency - stats.averageLatency);
+      stats.averageDetectionTime += averageWeight * (detectionTime - stats.averageDetectionTime);
+    }
+    stats.maxLatency = std::max(stats.maxLatency, latency);
+    stats.processedFrames++;
+  }
+
+  if (runningCount_ == 0)
+    idleCondition_.notify_all();
+
+  Dispatch();
+}
+}
+}
@@ -0,0 +1,111 @@
+#include <glar/vision/marker_detector.h>
+
+#include <iostream>
+
+#include <opencv2/calib3d.hpp>
+
+namespace glar
+{
+namespace vision
+{
+void MarkerDetection::Clear()
+{
+  ids.clear();
+  corners.clear();
+  rejected.clear();
+  rvecs.clear();
+  tvecs.clear();
+}
+
+MarkerDetector::MarkerDetector(float markerSize)
+  : markerSize_(markerSize)
+{
+  parameters_ = cv::aruco::DetectorParameters::create();
+  dictionary_ = cv::aruco::getPredefinedDictionary(cv::aruco::DICT_6X6_250);
+}
+
+MarkerDetector::~MarkerDetector() = default;
+
+void MarkerDetector::SetCameraParameters(cv::Mat cameraMatrix, cv::Mat distortion)
+{
+  cameraMatrix_ = cameraMatrix.clone();
+  distortion_ = distortion.clone();
+}
+
+bool MarkerDetector::LoadParameters(const std::string& filepath)
+{
+  cv::FileStorage fs(filepath, cv::FileStorage::READ);
+  if (!fs.isOpened())
+    return false;
+
+  auto parameters = cv::aruco::DetectorParameters::create();
+  if (!cv::aruco::DetectorParameters::readDetectorParameters(fs.root(), parameters))
+  {
+    std::cerr << "Failed to read detector parameters: " << filepath << std::endl;
+    return false;
+  }
+
+  parameters_ = parameters;
+  return true;
+}
+
+void MarkerDetector::Detect(const cv::Mat& image, MarkerDetection& detection, bool estimatePose) const
+{
+  // Marker outputs are overwritten in place, so corner lists of an earlier detection keep their capacity
+  detection.rvecs.clear();
+  detection.tvecs.clear();
+
+  cv::aruco::detectMarkers(image, dictionary_, detection.corners, detection.ids, parameters_, detection.rejected);
+
+  if (estimatePose && !detection.corners.empty())
+  {
+    cv::aruco::estimatePoseSingleMarkers(detection.corners, markerSize_, cameraMatrix_, distortion_,
+      detection.rvecs, detection.tvecs);
+  }
+}
+
+void MarkerDetector::Detect(const cv::Mat& image, MarkerDetection& detection, PoseSolver& poseSolver) const
+{
+  Detect(image, detection, false);
+
+  if (!detection.corners.empty())
+    poseSolver.Solve(detection.ids, detection.corners, cameraMatrix_, distortion_, detection.rvecs, detection.tvecs);
+}
+
+void MarkerDetector::DrawDetection(cv::Mat& image, const MarkerDetection& detection) const
+{
+  cv::aruco::drawDetectedMarkers(image, detection.corners, detection.ids);
+
+  for (int i = 0; i < detection.rvecs.size(); i++)
+    cv::aruco::drawAxis(image, cameraMatrix_, distortion_, detection.rvecs[i], detection.tvecs[i], markerSize_ / 2.f);
+}
+
+glm::mat4 MarkerDetector::ModelMatrix(const cv::Vec3d& rvec, const cv::Vec3d& tvec) const
+{
+  cv::Mat rot;
+  cv::Rodrigues(rvec, rot);
+
+  glm::mat4 model(1.f);
+  for (int r = 0; r < 3; r++)
+  {
+    for (int c = 0; c < 3; c++)
+      model[c][r] = rot.at<double>(r, c) * (markerSize_ / 2.f);
+    model[3][r] = tvec(r);
+  }
+  model[3][3] = 1.f;
+
+  return model;
+}
+
+glm::mat3 MarkerDetector::Intrinsic() const
+{
+  glm::mat3 intrinsic(1.f);
+  for (int r = 0; r < 3; r++)
+  {
+    for (int c = 0; c < 3; c++)
+      intrinsic[c][r] = cameraMatrix_.at<double>(r, c);
+  }
+  return intrinsic;
+}
+}
+}
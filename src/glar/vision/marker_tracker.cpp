@@ -0,0 +1,130 @@
+#include <glar/vision/marker_tracker.h>
+
+#include <chrono>
+
+#include <opencv2/imgproc.hpp>
+#include <opencv2/video.hpp>
+
+namespace glar
+{
+namespace vision
+{
+namespace
+{
+// Weight of a new sample in exponential moving averages
+constexpr double averageWeight = 0.1;
+}
+
+MarkerTracker::MarkerTracker(const MarkerDetector& detector, const CreateInfo& createInfo)
+  : detector_(detector)
+  , createInfo_(createInfo)
+{
+}
+
+MarkerTracker::~MarkerTracker() = default;
+
+MarkerTrackerStats MarkerTracker::Stats() const
+{
+  std::unique_lock<std::mutex> guard(statsMutex_);
+  return stats_;
+}
+
+bool MarkerTracker::Track(const cv::Mat& image, MarkerDetection& detection, PoseSolver& poseSolver)
+{
+  const auto startTime = std::chrono::high_resolution_clock::now();
+
+  if (image.channels() == 1)
+    gray_ = image;
+  else
+    cv::cvtColor(image, gray_, cv::COLOR_BGR2GRAY);
+
+  const cv::Size window(createInfo_.windowSize, createInfo_.windowSize);
+  cv::buildOpticalFlowPyramid(gray_, pyramid_, window, createInfo_.pyramidLevels);
+
+  // Nothing to track without markers
+  bool detect = ids_.empty() || previousPyramid_.empty() || framesSinceDetection_ + 1 >= createInfo_.detectionInterval;
+  bool lost = false;
+
+  if (!detect)
+  {
+    detection.Clear();
+    if (TrackCorners(detection))
+    {
+      framesSinceDetection_++;
+    }
+    else
+    {
+      lost = true;
+      detect = true;
+    }
+  }
+
+  if (detect)
+  {
+    detector_.Detect(image, detection, false);
+    framesSinceDetection_ = 0;
+  }
+
+  ids_ = detection.ids;
+  corners_ = detection.corners;
+  std::swap(previousPyramid_, pyramid_);
+
+  if (!detection.corners.empty())
+    poseSolver.Solve(detection.ids, detection.corners, detector_.CameraMatrix(), detector_.Distortion(), detection.rvecs, detection.tvecs);
+
+  const auto elapsed = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - startTime).count();
+
+  std::unique_lock<std::mutex> guard(statsMutex_);
+  auto& average = detect ? stats_.averageDetectionTime : stats_.averageTrackingTime;
+  const auto sampleCount = detect ? stats_.detectionCount : stats_.frameCount - stats_.detectionCount;
+  if (sampleCount == 0)
+    average = elapsed;
+  else
+    average += averageWeight * (elapsed - average);
+
+  stats_.frameCount++;
+  if (detect)
+    stats_.detectionCount++;
+  if (lost)
+    stats_.lostCount++;
+
+  return detect;
+}
+
+bool MarkerTracker::TrackCorners(MarkerDetection& detection)
+{
+  points_.clear();
+  for (const auto& markerCorners : corners_)
+    points_.insert(points_.end(), markerCorners.begin(), markerCorners.end());
+
+  const cv::Size window(createInfo_.windowSize, createInfo_.windowSize);
+  const cv::TermCriteria criteria(cv::TermCriteria::COUNT | cv::TermCriteria::EPS, 30, 0.01);
+
+  cv::calcOpticalFlowPyrLK(previousPyramid_, pyramid_, points_, forwardPoints_, forwardStatus_, errors_,
+    window, createInfo_.pyramidLevels, criteria);
+
+  // Backward from the tracked points should come back to the start
+  backwardPoints_ = points_;
+  cv::calcOpticalFlowPyrLK(pyramid_, previousPyramid_, forwardPoints_, backwardPoints_, backwardStatus_, errors_,
+    window, createInfo_.pyramidLevels, criteria, cv::OPTFLOW_USE_INITIAL_FLOW);
+
+  const auto maxSquareError = createInfo_.maxForwardBackwardError * createInfo_.maxForwardBackwardError;
+
+  for (int i = 0; i < ids_.size(); i++)
+  {
+    for (int j = 0; j < 4; j++)
+    {
+      const auto k = 4 * i + j;
+      const auto d = backwardPoints_[k] - points_[k];
+      if (!forwardStatus_[k] || !backwardStatus_[k] || d.x * d.x + d.y * d.y > maxSquareError)
+        return false;
+    }
+
+    detection.ids.push_back(ids_[i]);
+    detection.corners.emplace_back(forwardPoints_.begin() + 4 * i, forwardPoints_.begin() + 4 * i + 4);
+  }
+
+  return true;
+}
+}
+}
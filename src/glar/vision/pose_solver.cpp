@@ -0,0 +1,262 @@
+#include <glar/vision/pose_solver.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <map>
+#include <stdexcept>
+
+#include <opencv2/calib3d.hpp>
+
+namespace glar
+{
+namespace vision
+{
+namespace
+{
+// Weight of a new sample in exponential moving averages
+constexpr double averageWeight = 0.1;
+
+// Markers of a frame are solved in parallel from this count
+constexpr int parallelMarkerCount = 4;
+
+class IterativePoseSolver : public PoseSolver
+{
+public:
+  explicit IterativePoseSolver(float markerSize)
+    : PoseSolver(markerSize)
+  {
+  }
+
+protected:
+  double SolveMarker(const std::vector<cv::Point2f>& corners, const cv::Mat& cameraMatrix, const cv::Mat& distortion,
+    bool useGuess, cv::Vec3d& rvec, cv::Vec3d& tvec) const override
+  {
+    cv::solvePnP(ObjectPoints(), corners, cameraMatrix, distortion, rvec, tvec, false, cv::SOLVEPNP_ITERATIVE);
+    return ReprojectionError(corners, cameraMatrix, distortion, rvec, tvec);
+  }
+};
+
+class IppeSquarePoseSolver : public PoseSolver
+{
+public:
+  explicit IppeSquarePoseSolver(float markerSize)
+    : PoseSolver(markerSize)
+  {
+  }
+
+protected:
+  double SolveMarker(const std::vector<cv::Point2f>& corners, const cv::Mat& cameraMatrix, const cv::Mat& distortion,
+    bool useGuess, cv::Vec3d& rvec, cv::Vec3d& tvec) const override
+  {
+    cv::solvePnP(ObjectPoints(), corners, cameraMatrix, distortion, rvec, tvec, false, cv::SOLVEPNP_IPPE_SQUARE);
+    return ReprojectionError(corners, cameraMatrix, distortion, rvec, tvec);
+  }
+};
+
+class TrackingPoseSolver : public PoseSolver
+{
+private:
+  // Markers not seen for longer are solved from scratch
+  static constexpr int maxMissedFrames = 5;
+
+  // Warm-started solutions worse than this are solved from scratch, in pixels
+  static constexpr double maxGuessedError = 2.;
+
+  struct Track
+  {
+    cv::Vec3d rvec;
+    cv::Vec3d tvec;
+    int missedFrames = 0;
+  };
+
+public:
+  explicit TrackingPoseSolver(float markerSize)
+    : PoseSolver(markerSize)
+  {
+  }
+
+protected:
+  bool Guess(int id, cv::Vec3d& rvec, cv::Vec3d& tvec) override
+  {
+    auto it = tracks_.find(id);
+    if (it == tracks_.end())
+      return false;
+
+    rvec = it->second.rvec;
+    tvec = it->second.tvec;
+    return true;
+  }
+
+  double SolveMarker(const std::vector<cv::Point2f>& corners, const cv::Mat& cameraMatrix, const cv::Mat& distortion,
+    bool useGuess, cv::Vec3d& rvec, cv::Vec3d& tvec) const override
+  {
+    if (useGuess)
+    {
+      cv::solvePnP(ObjectPoints(), corners, cameraMatrix, distortion, rvec, tvec, true, cv::SOLVEPNP_ITERATIVE);
+
+      const auto error = ReprojectionError(corners, cameraMatrix, distortion, rvec, tvec);
+      if (error <= maxGuessedError)
+        return error;
+    }
+
+    // New marker, or the guess fell into a wrong minimum
+    cv::solvePnP(ObjectPoints(), corners, cameraMatrix, distortion, rvec, tvec, false, cv::SOLVEPNP_IPPE_SQUARE);
+    return ReprojectionError(corners, cameraMatrix, distortion, rvec, tvec);
+  }
+
+  void Update(const std::vector<int>& ids, const std::vector<cv::Vec3d>& rvecs, const std::vector<cv::Vec3d>& tvecs) override
+  {
+    for (auto& track : tracks_)
+      track.second.missedFrames++;
+
+    for (int i = 0; i < ids.size(); i++)
+    {
+      auto& track = tracks_[ids[i]];
+      track.rvec = rvecs[i];
+      track.tvec = tvecs[i];
+      track.missedFrames = 0;
+    }
+
+    for (auto it = tracks_.begin(); it != tracks_.end();)
+    {
+      if (it->second.missedFrames > maxMissedFrames)
+        it = tracks_.erase(it);
+      else
+        ++it;
+    }
+  }
+
+private:
+  std::map<int, Track> tracks_;
+};
+}
+
+const char* PoseSolver::ToString(Type type)
+{
+  switch (type)
+  {
+  case Type::ITERATIVE:
+    return "Iterative";
+  case Type::IPPE_SQUARE:
+    return "IPPE square";
+  case Type::TRACKING:
+    return "Tracking";
+  default:
+    return "";
+  }
+}
+
+std::unique_ptr<PoseSolver> PoseSolver::Create(Type type, float markerSize)
+{
+  switch (type)
+  {
+  case Type::ITERATIVE:
+    return std::make_unique<IterativePoseSolver>(markerSize);
+  case Type::IPPE_SQUARE:
+    return std::make_unique<IppeSquarePoseSolver>(markerSize);
+  case Type::TRACKING:
+    return std::make_unique<TrackingPoseSolver>(markerSize);
+  default:
+    throw std::runtime_error("Unknown pose solver type");
+  }
+}
+
+PoseSolver::PoseSolver(float markerSize)
+  : markerSize_(markerSize)
+{
+  // Same corner order as cv::aruco
+  const auto l = markerSize / 2.f;
+  objectPoints_ = {
+    cv::Point3f(-l, l, 0.f),
+    cv::Point3f(l, l, 0.f),
+    cv::Point3f(l, -l, 0.f),
+    cv::Point3f(-l, -l, 0.f),
+  };
+}
+
+PoseSolver::~PoseSolver() = default;
+
+PoseSolverStats PoseSolver::Stats() const
+{
+  std::unique_lock<std::mutex> guard(statsMutex_);
+  return stats_;
+}
+
+void PoseSolver::Solve(const std::vector<int>& ids, const std::vector<std::vector<cv::Point2f>>& corners,
+  const cv::Mat& cameraMatrix, const cv::Mat& distortion,
+  std::vector<cv::Vec3d>& rvecs, std::vector<cv::Vec3d>& tvecs)
+{
+  const auto markerCount = static_cast<int>(corners.size());
+
+  rvecs.resize(markerCount);
+  tvecs.resize(markerCount);
+  useGuess_.resize(markerCount);
+  errors_.resize(markerCount);
+
+  if (markerCount == 0)
+    return;
+
+  const auto startTime = std::chrono::high_resolution_clock::now();
+
+  for (int i = 0; i < markerCount; i++)
+    useGuess_[i] = Guess(ids[i], rvecs[i], tvecs[i]);
+
+  const auto solve = [&](const cv::Range& range)
+  {
+    for (int i = range.start; i < range.end; i++)
+      errors_[i] = SolveMarker(corners[i], cameraMatrix, distortion, useGuess_[i] != 0, rvecs[i], tvecs[i]);
+  };
+
+  if (markerCount >= parallelMarkerCount)
+    cv::parallel_for_(cv::Range(0, markerCount), solve);
+  else
+    solve(cv::Range(0, markerCount));
+
+  const auto endTime = std::chrono::high_resolution_clock::now();
+
+  Update(ids, rvecs, tvecs);
+
+  const auto solveTime = std::chrono::duration<double>(endTime - startTime).count() / markerCount;
+
+  double errorSum = 0.;
+  double maxError = 0.;
+  for (auto error : errors_)
+  {
+    errorSum += error;
+    maxError = std::max(maxError, error);
+  }
+  const auto error = errorSum / markerCount;
+
+  std::unique_lock<std::mutex> guard(statsMutex_);
+  if (stats_.frameCount == 0)
+  {
+    stats_.averageSolveTime = solveTime;
+    stats_.averageReprojectionError = error;
+  }
+  else
+  {
+    stats_.averageSolveTime += averageWeight * (solveTime - stats_.averageSolveTime);
+    stats_.averageReprojectionError += averageWeight * (error - stats_.averageReprojectionError);
+  }
+  stats_.maxReprojectionError = std::max(stats_.maxReprojectionError, maxError);
+  stats_.frameCount++;
+  stats_.markerCount += markerCount;
+}
+
+double PoseSolver::ReprojectionError(const std::vector<cv::Point2f>& corners, const cv::Mat& cameraMatrix, const cv::Mat& distortion,
+  const cv::Vec3d& rvec, const cv::Vec3d& tvec) const
+{
+  std::vector<cv::Point2f> projected;
+  cv::projectPoints(objectPoints_, rvec, tvec, cameraMatrix, distortion, projected);
+
+  double squareSum = 0.;
+  for (int i = 0; i < corners.size(); i++)
+  {
+    const auto d = projected[i] - corners[i];
+    squareSum += d.x * d.x + d.y * d.y;
+  }
+  return std::sqrt(squareSum / corners.size());
+}
+}
+}
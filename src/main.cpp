@@ -1,13 +1,58 @@
 #include <iostream>
+#include <string>
+#include <sstream>
+#include <vector>
 
 #include <glar/application.h>
 
-int main()
+namespace
+{
+void PrintUsage()
+{
+  std::cerr << "Usage:" << std::endl
+    << "  glar" << std::endl
+    << "  glar --batch <input video> <output video> [--workers 1,2,4,...]" << std::endl;
+}
+
+std::vector<int> ParseWorkerCounts(const std::string& s)
+{
+  std::vector<int> workerCounts;
+
+  std::istringstream ss(s);
+  std::string token;
+  while (std::getline(ss, token, ','))
+    workerCounts.push_back(std::stoi(token));
+
+  return workerCounts;
+}
+}
+
+int main(int argc, char** argv)
 {
   try
   {
-    glar::Application app;
-    app.Run();
+    const std::vector<std::string> args(argv + 1, argv + argc);
+
+    if (!args.empty() && args[0] == "--batch")
+    {
+      if ((args.size() != 3 && args.size() != 5) || (args.size() == 5 && args[3] != "--workers"))
+      {
+        PrintUsage();
+        return 1;
+      }
+
+      std::vector<int> workerCounts = { 1, 2, 4, 8 };
+      if (args.size() == 5)
+        workerCounts = ParseWorkerCounts(args[4]);
+
+      glar::Application app;
+      app.RunBatch(args[1], args[2], workerCounts);
+    }
+    else
+    {
+      glar::Application app;
+      app.Run();
+    }
   }
   catch (const std::exception& e)
   {
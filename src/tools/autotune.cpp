@@ -0,0 +1,412 @@
+#include "tools.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <opencv2/core.hpp>
+#include <opencv2/aruco.hpp>
+#include <opencv2/imgproc.hpp>
+#include <opencv2/videoio.hpp>
+
+#include <glar/vision/marker_detector.h>
+
+namespace glar
+{
+namespace tools
+{
+namespace
+{
+// Same as the app
+constexpr float markerSize = 0.042f;
+constexpr int markerId = 23;
+
+struct Frame
+{
+  cv::Mat image;
+
+  // Ground truth for synthetic frames, reference detection for recorded frames
+  std::vector<int> ids;
+  std::vector<std::vector<cv::Point2f>> corners;
+};
+
+struct Config
+{
+  int adaptiveThreshWinSizeMin;
+  int adaptiveThreshWinSizeMax;
+  int adaptiveThreshWinSizeStep;
+  double minMarkerPerimeterRate;
+  double maxMarkerPerimeterRate;
+  double polygonalApproxAccuracyRate;
+  int cornerRefinementMethod;
+
+  // Measured
+  double detectionTime = 0.; // Seconds per frame
+  double recall = 0.;
+  double cornerError = std::numeric_limits<double>::infinity(); // RMS in pixels
+};
+
+const char* CornerRefinementName(int method)
+{
+  switch (method)
+  {
+  case cv::aruco::CORNER_REFINE_NONE: return "none";
+  case cv::aruco::CORNER_REFINE_SUBPIX: return "subpix";
+  case cv::aruco::CORNER_REFINE_CONTOUR: return "contour";
+  default: return "?";
+  }
+}
+
+cv::Ptr<cv::aruco::DetectorParameters> CreateParameters(const Config& config)
+{
+  auto parameters = cv::aruco::DetectorParameters::create();
+  parameters->adaptiveThreshWinSizeMin = config.adaptiveThreshWinSizeMin;
+  parameters->adaptiveThreshWinSizeMax = config.adaptiveThreshWinSizeMax;
+  parameters->adaptiveThreshWinSizeStep = config.adaptiveThreshWinSizeStep;
+  parameters->minMarkerPerimeterRate = config.minMarkerPerimeterRate;
+  parameters->maxMarkerPerimeterRate = config.maxMarkerPerimeterRate;
+  parameters->polygonalApproxAccuracyRate = config.polygonalApproxAccuracyRate;
+  parameters->cornerRefinementMethod = config.cornerRefinementMethod;
+  return parameters;
+}
+
+std::vector<Config> SweepConfigs()
+{
+  std::vector<Config> configs;
+  for (int winSizeMin : { 3, 5 })
+  for (int winSizeMax : { 15, 23 })
+  for (int winSizeStep : { 4, 10 })
+  for (double minPerimeterRate : { 0.01, 0.03, 0.05 })
+  for (double maxPerimeterRate : { 1., 4. })
+  for (double approxRate : { 0.03, 0.05, 0.08 })
+  for (int refinement : { cv::aruco::CORNER_REFINE_NONE, cv::aruco::CORNER_REFINE_SUBPIX, cv::aruco::CORNER_REFINE_CONTOUR })
+  {
+    Config config;
+    config.adaptiveThreshWinSizeMin = winSizeMin;
+    config.adaptiveThreshWinSizeMax = winSizeMax;
+    config.adaptiveThreshWinSizeStep = winSizeStep;
+    config.minMarkerPerimeterRate = minPerimeterRate;
+    config.maxMarkerPerimeterRate = maxPerimeterRate;
+    config.polygonalApproxAccuracyRate = approxRate;
+    config.cornerRefinementMethod = refinement;
+    configs.push_back(config);
+  }
+  return configs;
+}
+
+// Markers warped onto a noisy background with known corners
+Frame CreateSyntheticFrame(cv::RNG& rng, const cv::Ptr<cv::aruco::Dictionary>& dictionary)
+{
+  constexpr int width = 640;
+  constexpr int height = 480;
+
+  Frame frame;
+  frame.image = cv::Mat(height, width, CV_8UC1);
+  cv::randu(frame.image, cv::Scalar(64), cv::Scalar(192));
+  cv::GaussianBlur(frame.image, frame.image, cv::Size(0, 0), 8.);
+
+  const auto markerCount = rng.uniform(1, 4);
+  for (int i = 0; i < markerCount; i++)
+  {
+    const auto id = i == 0 ? markerId : rng.uniform(0, 250);
+
+    // 6x6 bits and black border, then a white quiet zone of one cell
+    constexpr int cellPixels = 16;
+    cv::Mat marker;
+    cv::aruco::drawMarker(dictionary, id, 8 * cellPixels, marker);
+    cv::copyMakeBorder(marker, marker, cellPixels, cellPixels, cellPixels, cellPixels, cv::BORDER_CONSTANT, cv::Scalar(255));
+
+    const std::vector<cv::Point2f> source = {
+      cv::Point2f(cellPixels, cellPixels),
+      cv::Point2f(9 * cellPixels, cellPixels),
+      cv::Point2f(9 * cellPixels, 9 * cellPixels),
+      cv::Point2f(cellPixels, 9 * cellPixels),
+    };
+
+    // Rotated square with perspective jitter, inside the frame
+    const auto size = rng.uniform(40.f, 200.f);
+    const auto center = cv::Point2f(rng.uniform(size, width - size), rng.uniform(size, height - size));
+    const auto angle = rng.uniform(0.f, static_cast<float>(2. * CV_PI));
+
+    std::vector<cv::Point2f> corners;
+    for (int j = 0; j < 4; j++)
+    {
+      const auto a = angle + static_cast<float>(CV_PI / 2.) * j;
+      const auto jitter = cv::Point2f(rng.uniform(-0.1f, 0.1f), rng.uniform(-0.1f, 0.1f)) * size;
+      corners.push_back(center + cv::Point2f(std::cos(a), std::sin(a)) * (size / std::sqrt(2.f)) + jitter);
+    }
+
+    // Skip overlapping markers
+    bool overlap = false;
+    for (const auto& other : frame.corners)
+    {
+      const auto d = other[0] - corners[0];
+      overlap |= std::sqrt(d.x * d.x + d.y * d.y) < 2.f * size;
+    }
+    if (overlap)
+      continue;
+
+    const auto homography = cv::getPerspectiveTransform(source, corners);
+    cv::warpPerspective(marker, frame.image, homography, frame.image.size(), cv::INTER_LINEAR, cv::BORDER_TRANSPARENT);
+
+    frame.ids.push_back(id);
+    frame.corners.push_back(corners);
+  }
+
+  // Camera blur and noise
+  const auto sigma = rng.uniform(0.1, 1.5);
+  cv::GaussianBlur(frame.image, frame.image, cv::Size(0, 0), sigma);
+
+  cv::Mat noise(frame.image.size(), CV_16SC1);
+  cv::randn(noise, cv::Scalar(0), cv::Scalar(rng.uniform(1., 6.)));
+  cv::Mat image;
+  frame.image.convertTo(image, CV_16SC1);
+  cv::add(image, noise, image);
+  image.convertTo(frame.image, CV_8UC1);
+
+  return frame;
+}
+
+std::vector<Frame> LoadFrames(const std::string& source, int maxFrameCount, const vision::MarkerDetector& detector)
+{
+  std::vector<Frame> frames;
+
+  const std::string synthetic = "synthetic";
+  if (source.compare(0, synthetic.size(), synthetic) == 0)
+  {
+    const auto count = source.size() > synthetic.size() + 1 ? std::stoi(source.substr(synthetic.size() + 1)) : maxFrameCount;
+
+    cv::RNG rng(markerId);
+    for (int i = 0; i < count; i++)
+      frames.push_back(CreateSyntheticFrame(rng, detector.Dictionary()));
+    return frames;
+  }
+
+  // Video file or image sequence such as frames/%04d.png
+  cv::VideoCapture capture(source);
+  if (!capture.isOpened())
+    throw std::runtime_error("Failed to open frames: " + source);
+
+  // Careful detection as reference
+  auto reference = cv::aruco::DetectorParameters::create();
+  reference->cornerRefinementMethod = cv::aruco::CORNER_REFINE_SUBPIX;
+
+  cv::Mat image;
+  while (frames.size() < maxFrameCount && capture.read(image))
+  {
+    Frame frame;
+    cv::cvtColor(image, frame.image, cv::COLOR_BGR2GRAY);
+    cv::aruco::detectMarkers(frame.image, detector.Dictionary(), frame.corners, frame.ids, reference);
+    frames.push_back(std::move(frame));
+  }
+
+  return frames;
+}
+
+void Evaluate(Config& config, const std::vector<Frame>& frames, const vision::MarkerDetector& detector)
+{
+  const auto parameters = CreateParameters(config);
+
+  std::vector<int> ids;
+  std::vector<std::vector<cv::Point2f>> corners;
+
+  double seconds = 0.;
+  int expectedCount = 0;
+  int matchedCount = 0;
+  double squareErrorSum = 0.;
+
+  for (const auto& frame : frames)
+  {
+    const auto startTime = std::chrono::high_resolution_clock::now();
+    cv::aruco::detectMarkers(frame.image, detector.Dictionary(), corners, ids, parameters);
+    seconds += std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - startTime).count();
+
+    for (int i = 0; i < frame.ids.size(); i++)
+    {
+      expectedCount++;
+
+      // Same id and corners within a few pixels
+      for (int j = 0; j < ids.size(); j++)
+      {
+        if (ids[j] != frame.ids[i])
+          continue;
+
+        double squareError = 0.;
+        for (int k = 0; k < 4; k++)
+        {
+          const auto d = corners[j][k] - frame.corners[i][k];
+          squareError += d.x * d.x + d.y * d.y;
+        }
+
+        constexpr double maxMatchError = 5.;
+        if (squareError / 4. < maxMatchError * maxMatchError)
+        {
+          matchedCount++;
+          squareErrorSum += squareError;
+          break;
+        }
+      }
+    }
+  }
+
+  config.detectionTime = seconds / frames.size();
+  config.recall = expectedCount > 0 ? static_cast<double>(matchedCount) / expectedCount : 0.;
+  if (matchedCount > 0)
+    config.cornerError = std::sqrt(squareErrorSum / (4. * matchedCount));
+}
+
+bool Dominates(const Config& lhs, const Config& rhs)
+{
+  const bool notWorse = lhs.detectionTime <= rhs.detectionTime && lhs.recall >= rhs.recall && lhs.cornerError <= rhs.cornerError;
+  const bool better = lhs.detectionTime < rhs.detectionTime || lhs.recall > rhs.recall || lhs.cornerError < rhs.cornerError;
+  return notWorse && better;
+}
+
+// Sorted by detection time
+std::vector<Config> ParetoFront(const std::vector<Config>& configs)
+{
+  std::vector<Config> front;
+  for (const auto& config : configs)
+  {
+    bool dominated = false;
+    for (const auto& other : configs)
+    {
+      if (Dominates(other, config))
+      {
+        dominated = true;
+        break;
+      }
+    }
+
+    if (!dominated)
+      front.push_back(config);
+  }
+
+  std::sort(front.begin(), front.end(), [](const Config& lhs, const Config& rhs) { return lhs.detectionTime < rhs.detectionTime; });
+  return front;
+}
+
+void WriteParameters(cv::FileStorage& fs, const Config& config)
+{
+  fs
+    << "adaptiveThreshWinSizeMin" << config.adaptiveThreshWinSizeMin
+    << "adaptiveThreshWinSizeMax" << config.adaptiveThreshWinSizeMax
+    << "adaptiveThreshWinSizeStep" << config.adaptiveThreshWinSizeStep
+    << "minMarkerPerimeterRate" << config.minMarkerPerimeterRate
+    << "maxMarkerPerimeterRate" << config.maxMarkerPerimeterRate
+    << "polygonalApproxAccuracyRate" << config.polygonalApproxAccuracyRate
+    << "cornerRefinementMethod" << config.cornerRefinementMethod;
+}
+
+void WriteMeasurements(cv::FileStorage& fs, const Config& config)
+{
+  fs
+    << "detectionTime" << config.detectionTime
+    << "recall" << config.recall
+    << "cornerError" << (std::isfinite(config.cornerError) ? config.cornerError : -1.);
+}
+
+void PrintUsage()
+{
+  std::cerr << "Usage:" << std::endl
+    << "  glar_tools autotune <video | image sequence | synthetic[:count]> <output profile.yml>" << std::endl
+    << "    [--max-frames 100] [--min-recall 0.95] [--max-error 1.0]" << std::endl;
+}
+}
+
+int Autotune(const std::vector<std::string>& args)
+{
+  if (args.size() < 2 || args.size() % 2 != 0)
+  {
+    PrintUsage();
+    return 1;
+  }
+
+  int maxFrameCount = 100;
+  double minRecall = 0.95;
+  double maxError = 1.;
+  for (int i = 2; i < args.size(); i += 2)
+  {
+    if (args[i] == "--max-frames")
+      maxFrameCount = std::stoi(args[i + 1]);
+    else if (args[i] == "--min-recall")
+      minRecall = std::stod(args[i + 1]);
+    else if (args[i] == "--max-error")
+      maxError = std::stod(args[i + 1]);
+    else
+    {
+      PrintUsage();
+      return 1;
+    }
+  }
+
+  vision::MarkerDetector detector(markerSize);
+
+  const auto frames = LoadFrames(args[0], maxFrameCount, detector);
+  if (frames.empty())
+    throw std::runtime_error("No frames to tune with: " + args[0]);
+
+  std::cout << frames.size() << " frames loaded" << std::endl;
+
+  auto configs = SweepConfigs();
+  for (int i = 0; i < configs.size(); i++)
+  {
+    Evaluate(configs[i], frames, detector);
+
+    if ((i + 1) % 20 == 0 || i + 1 == configs.size())
+      std::cout << "Evaluated " << i + 1 << " / " << configs.size() << " configurations" << std::endl;
+  }
+
+  const auto front = ParetoFront(configs);
+
+  // Fastest one meeting the bar, otherwise the most accurate in recall
+  auto selected = std::find_if(front.begin(), front.end(), [minRecall, maxError](const Config& config)
+  {
+    return config.recall >= minRecall && config.cornerError <= maxError;
+  });
+  if (selected == front.end())
+  {
+    selected = std::max_element(front.begin(), front.end(), [](const Config& lhs, const Config& rhs) { return lhs.recall < rhs.recall; });
+    std::cout << "No configuration meets recall " << minRecall << " and corner error " << maxError << "px" << std::endl;
+  }
+
+  std::cout << std::endl << "Pareto front:" << std::endl;
+  for (const auto& config : front)
+  {
+    std::cout << (&config == &*selected ? "* " : "  ")
+      << std::fixed << std::setprecision(3)
+      << "time " << config.detectionTime * 1000. << "ms, recall " << config.recall << ", error " << config.cornerError << "px | "
+      << "window " << config.adaptiveThreshWinSizeMin << "-" << config.adaptiveThreshWinSizeMax << "/" << config.adaptiveThreshWinSizeStep
+      << ", perimeter " << config.minMarkerPerimeterRate << "-" << config.maxMarkerPerimeterRate
+      << ", approx " << config.polygonalApproxAccuracyRate
+      << ", refine " << CornerRefinementName(config.cornerRefinementMethod) << std::endl;
+  }
+
+  // Top level is the selected configuration, readable by DetectorParameters::readDetectorParameters
+  cv::FileStorage fs(args[1], cv::FileStorage::WRITE);
+  if (!fs.isOpened())
+    throw std::runtime_error("Failed to write profile: " + args[1]);
+
+  WriteParameters(fs, *selected);
+  WriteMeasurements(fs, *selected);
+
+  fs << "pareto" << "[";
+  for (const auto& config : front)
+  {
+    fs << "{";
+    WriteParameters(fs, config);
+    WriteMeasurements(fs, config);
+    fs << "}";
+  }
+  fs << "]";
+
+  std::cout << "Profile written to " << args[1] << std::endl;
+  return 0;
+}
+}
+}
@@ -0,0 +1,49 @@
+#include <functional>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "tools.h"
+
+namespace
+{
+const std::map<std::string, std::function<int(const std::vector<std::string>&)>> commands = {
+  { "autotune", glar::tools::Autotune },
+  { "mjpeg_server", glar::tools::MjpegServer },
+  { "shm_latency", glar::tools::ShmLatency },
+  { "telemetry_to_csv", glar::tools::TelemetryToCsv },
+};
+
+void PrintUsage()
+{
+  std::cerr << "Usage:" << std::endl
+    << "  glar_tools <command> [args...]" << std::endl
+    << std::endl
+    << "Commands:" << std::endl;
+
+  for (const auto& command : commands)
+    std::cerr << "  " << command.first << std::endl;
+}
+}
+
+int main(int argc, char** argv)
+{
+  try
+  {
+    const std::vector<std::string> args(argv + 1, argv + argc);
+
+    if (args.empty() || commands.find(args[0]) == commands.end())
+    {
+      PrintUsage();
+      return 1;
+    }
+
+    return commands.at(args[0])(std::vector<std::string>(args.begin() + 1, args.end()));
+  }
+  catch (const std::exception& e)
+  {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+}
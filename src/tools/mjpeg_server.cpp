@@ -0,0 +1,167 @@
+#include "tools.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <opencv2/core.hpp>
+#include <opencv2/core/utility.hpp>
+#include <opencv2/core/utils/filesystem.hpp>
+#include <opencv2/imgcodecs.hpp>
+#include <opencv2/videoio.hpp>
+
+#include <glar/util/socket.h>
+
+namespace glar
+{
+namespace tools
+{
+namespace
+{
+const std::string boundary = "glarframe";
+
+using Jpeg = std::vector<uint8_t>;
+
+bool IsJpegFile(const std::string& filepath)
+{
+  const auto dot = filepath.find_last_of('.');
+  const auto separator = filepath.find_last_of("/\\");
+  if (dot == std::string::npos || (separator != std::string::npos && dot < separator))
+    return false;
+
+  auto extension = filepath.substr(dot);
+  std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+  return extension == ".jpg" || extension == ".jpeg";
+}
+
+// JPEG files of a directory are served as they are, frames of a video or image sequence are encoded
+std::vector<Jpeg> LoadFrames(const std::string& source, int quality)
+{
+  std::vector<Jpeg> frames;
+
+  if (cv::utils::fs::isDirectory(source))
+  {
+    // Regular files sorted by name
+    std::vector<cv::String> filepaths;
+    cv::glob(source, filepaths, false);
+
+    for (const auto& filepath : filepaths)
+    {
+      if (!IsJpegFile(filepath))
+        continue;
+
+      std::ifstream in(filepath, std::ios::binary);
+      frames.emplace_back(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    return frames;
+  }
+
+  cv::VideoCapture capture(source);
+  if (!capture.isOpened())
+    throw std::runtime_error("Failed to open frames: " + source);
+
+  const std::vector<int> parameters = { cv::IMWRITE_JPEG_QUALITY, quality };
+
+  cv::Mat image;
+  while (capture.read(image))
+  {
+    Jpeg jpeg;
+    cv::imencode(".jpg", image, jpeg, parameters);
+    frames.push_back(std::move(jpeg));
+  }
+  return frames;
+}
+
+void Serve(std::unique_ptr<util::Socket> client, const std::vector<Jpeg>& frames, double fps, bool contentLength)
+{
+  // Request is not checked, any path gets the stream
+  char request[4096];
+  client->Receive(request, sizeof(request));
+
+  if (!client->Send(
+    "HTTP/1.0 200 OK\r\n"
+    "Cache-Control: no-cache\r\n"
+    "Content-Type: multipart/x-mixed-replace; boundary=" + boundary + "\r\n"
+    "\r\n"))
+    return;
+
+  const auto frameInterval = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(1. / fps));
+  auto frameTime = std::chrono::steady_clock::now();
+
+  uint64_t frameCount = 0;
+  for (size_t i = 0; ; i = (i + 1) % frames.size())
+  {
+    const auto& frame = frames[i];
+
+    std::string header = "--" + boundary + "\r\nContent-Type: image/jpeg\r\n";
+    if (contentLength)
+      header += "Content-Length: " + std::to_string(frame.size()) + "\r\n";
+    header += "\r\n";
+
+    if (!client->Send(header) || !client->Send(frame.data(), frame.size()) || !client->Send("\r\n"))
+      break;
+    frameCount++;
+
+    frameTime += frameInterval;
+    std::this_thread::sleep_until(frameTime);
+  }
+
+  std::cout << "Client disconnected after " << frameCount << " frames" << std::endl;
+}
+}
+
+int MjpegServer(const std::vector<std::string>& args)
+{
+  if (args.empty())
+  {
+    std::cerr << "Usage: glar_tools mjpeg_server <jpeg directory | video | image sequence> [--port 8080] [--fps 30] "
+      << "[--quality 90] [--no-content-length]" << std::endl;
+    return 1;
+  }
+
+  int port = 8080;
+  double fps = 30.;
+  int quality = 90;
+  bool contentLength = true;
+  for (int i = 1; i < args.size(); i++)
+  {
+    if (args[i] == "--no-content-length")
+      contentLength = false;
+    else if (i + 1 >= args.size())
+      break;
+    else if (args[i] == "--port")
+      port = std::stoi(args[++i]);
+    else if (args[i] == "--fps")
+      fps = std::stod(args[++i]);
+    else if (args[i] == "--quality")
+      quality = std::stoi(args[++i]);
+  }
+
+  const auto frames = LoadFrames(args[0], quality);
+  if (frames.empty())
+    throw std::runtime_error("No frames to serve: " + args[0]);
+
+  auto server = util::Socket::Listen(static_cast<uint16_t>(port));
+
+  std::cout << "Serving " << frames.size() << " frames at " << fps << " fps on http://localhost:" << port << "/video" << std::endl;
+
+  // A thread per client, until the process is killed
+  while (auto client = server->Accept())
+  {
+    std::cout << "Client connected" << std::endl;
+    std::thread(Serve, std::move(client), std::cref(frames), fps, contentLength).detach();
+  }
+
+  return 0;
+}
+}
+}
@@ -0,0 +1,209 @@
+#include "tools.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <glar/ipc/pose_publisher.h>
+#include <glar/ipc/pose_reader.h>
+
+namespace glar
+{
+namespace tools
+{
+namespace
+{
+// Markers per synthetic frame
+constexpr int syntheticMarkerCount = 4;
+
+void PrintLatencies(const std::string& name, std::vector<int64_t> latencies)
+{
+  if (latencies.empty())
+  {
+    std::cout << std::left << std::setw(10) << name << "no samples" << std::endl;
+    return;
+  }
+
+  std::sort(latencies.begin(), latencies.end());
+  const auto percentile = [&latencies](double p)
+  {
+    return latencies[static_cast<size_t>(p * (latencies.size() - 1))] / 1000.;
+  };
+
+  std::cout << std::left << std::setw(10) << name << std::right << std::fixed << std::setprecision(1)
+    << std::setw(10) << latencies.size()
+    << std::setw(10) << percentile(0.5)
+    << std::setw(10) << percentile(0.99)
+    << std::setw(10) << latencies.back() / 1000. << std::endl;
+}
+
+// Stand-in for the app, publishing frames with a few marker poses at a fixed rate
+int Publish(const std::string& name, double rate, double seconds, uint32_t frameWidth, uint32_t frameHeight)
+{
+  ipc::PosePublisher::CreateInfo createInfo;
+  createInfo.name = name;
+  createInfo.frameCapacity = static_cast<uint64_t>(frameWidth) * frameHeight * 3;
+  ipc::PosePublisher publisher(createInfo);
+
+  std::vector<uint8_t> frame(createInfo.frameCapacity);
+
+  std::cout << "Publishing to " << name << " at " << rate << " Hz";
+  if (publisher.PublishesFrames())
+    std::cout << " with " << frameWidth << "x" << frameHeight << " frames";
+  std::cout << std::endl;
+
+  const auto interval = std::chrono::duration_cast<ipc::Clock::duration>(std::chrono::duration<double>(1. / rate));
+  const auto endTime = ipc::Clock::now() + std::chrono::duration_cast<ipc::Clock::duration>(std::chrono::duration<double>(seconds));
+
+  for (auto time = ipc::Clock::now(); time < endTime; time += interval)
+  {
+    std::this_thread::sleep_until(time);
+    const auto captureTime = ipc::Now();
+
+    auto frameSequence = ~0ull;
+    if (publisher.PublishesFrames())
+    {
+      std::fill(frame.begin(), frame.end(), static_cast<uint8_t>(publisher.stats().frameCount));
+
+      ipc::FrameInfo info;
+      info.captureTime = captureTime;
+      info.width = frameWidth;
+      info.height = frameHeight;
+      info.size = frame.size();
+      frameSequence = publisher.PublishFrame(info, frame.data());
+    }
+
+    for (int i = 0; i < syntheticMarkerCount; i++)
+    {
+      ipc::PoseRecord record;
+      record.frameSequence = frameSequence;
+      record.captureTime = captureTime;
+      record.markerId = i;
+      record.tvec[2] = 0.5;
+      publisher.PublishPose(record);
+    }
+  }
+
+  std::cout << "Published " << publisher.stats().poseCount << " poses and " << publisher.stats().frameCount << " frames" << std::endl;
+  return 0;
+}
+
+int Read(const std::string& name, double seconds)
+{
+  ipc::PoseReader reader(name);
+  std::cout << "Reading " << name << " for " << seconds << "s" << std::endl;
+
+  // Publish and capture to the time a pose or frame is seen, in nanoseconds
+  std::vector<int64_t> poseLatencies;
+  std::vector<int64_t> captureLatencies;
+  std::vector<int64_t> frameLatencies;
+  uint64_t lastFrameSequence = ~0ull;
+  uint64_t invalidatedFrameCount = 0;
+
+  const auto endTime = ipc::Clock::now() + std::chrono::duration_cast<ipc::Clock::duration>(std::chrono::duration<double>(seconds));
+  while (ipc::Clock::now() < endTime && reader.Connected())
+  {
+    bool idle = true;
+
+    ipc::PoseRecord record;
+    while (reader.Next(record))
+    {
+      const auto now = ipc::Now();
+      poseLatencies.push_back(now - record.publishTime);
+      captureLatencies.push_back(now - record.captureTime);
+      idle = false;
+    }
+
+    ipc::PoseReader::FrameView frame;
+    if (reader.HasFrames() && reader.LatestFrame(frame) && frame.info.sequence != lastFrameSequence)
+    {
+      frameLatencies.push_back(ipc::Now() - frame.info.publishTime);
+      lastFrameSequence = frame.info.sequence;
+
+      // Touches every page in place, as a consumer would
+      uint64_t sum = 0;
+      for (uint64_t i = 0; i < frame.info.size; i += 4096)
+        sum += frame.data[i];
+      if (!reader.Valid(frame) || (frame.info.size > 0 && sum != (frame.info.size + 4095) / 4096 * frame.data[0]))
+        invalidatedFrameCount++;
+
+      idle = false;
+    }
+
+    if (idle)
+      std::this_thread::yield();
+  }
+
+  if (!reader.Connected())
+    std::cout << "Publisher closed the channel" << std::endl;
+
+  std::cout << std::left << std::setw(10) << "Latency" << std::right
+    << std::setw(10) << "Count" << std::setw(10) << "p50(us)" << std::setw(10) << "p99(us)" << std::setw(10) << "max(us)" << std::endl;
+  PrintLatencies("pose", poseLatencies);
+  PrintLatencies("capture", captureLatencies);
+  if (reader.HasFrames())
+    PrintLatencies("frame", frameLatencies);
+
+  std::cout << "Dropped poses: " << reader.droppedCount() << std::endl;
+  if (reader.HasFrames())
+    std::cout << "Frames overwritten while read: " << invalidatedFrameCount << std::endl;
+
+  return 0;
+}
+
+void PrintUsage()
+{
+  std::cerr << "Usage:" << std::endl
+    << "  glar_tools shm_latency [--name glar_poses] [--seconds 10] [--publish <rate> [--frame-size 1280x720]]" << std::endl;
+}
+}
+
+int ShmLatency(const std::vector<std::string>& args)
+{
+  std::string name = ipc::defaultChannelName;
+  double seconds = 10.;
+  double publishRate = 0.;
+  uint32_t frameWidth = 0;
+  uint32_t frameHeight = 0;
+  for (size_t i = 0; i < args.size(); i++)
+  {
+    if (i + 1 >= args.size())
+    {
+      PrintUsage();
+      return 1;
+    }
+
+    if (args[i] == "--name")
+      name = args[++i];
+    else if (args[i] == "--seconds")
+      seconds = std::stod(args[++i]);
+    else if (args[i] == "--publish")
+      publishRate = std::stod(args[++i]);
+    else if (args[i] == "--frame-size")
+    {
+      const auto size = args[++i];
+      const auto x = size.find('x');
+      if (x == std::string::npos)
+        throw std::runtime_error("Frame size must be WIDTHxHEIGHT: " + size);
+      frameWidth = static_cast<uint32_t>(std::stoul(size.substr(0, x)));
+      frameHeight = static_cast<uint32_t>(std::stoul(size.substr(x + 1)));
+    }
+    else
+    {
+      PrintUsage();
+      return 1;
+    }
+  }
+
+  if (publishRate > 0.)
+    return Publish(name, publishRate, seconds, frameWidth, frameHeight);
+
+  return Read(name, seconds);
+}
+}
+}
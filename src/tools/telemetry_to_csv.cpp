@@ -0,0 +1,129 @@
+#include "tools.h"
+
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <glar/telemetry/log_reader.h>
+
+namespace glar
+{
+namespace tools
+{
+namespace
+{
+// Nanoseconds to milliseconds, keeping nanosecond precision
+std::string Milliseconds(int64_t nanoseconds)
+{
+  std::ostringstream out;
+  out << std::fixed << std::setprecision(6) << nanoseconds / 1e6;
+  return out.str();
+}
+
+std::ofstream OpenCsv(const std::string& filepath, const std::string& columns)
+{
+  std::ofstream out(filepath);
+  if (!out)
+    throw std::runtime_error("Failed to open for writing: " + filepath);
+
+  out << columns << std::endl;
+  return out;
+}
+}
+
+int TelemetryToCsv(const std::vector<std::string>& args)
+{
+  if (args.empty())
+  {
+    std::cerr << "Usage: glar_tools telemetry_to_csv <telemetry.bin> [output prefix]" << std::endl;
+    return 1;
+  }
+
+  const auto& inputFilepath = args[0];
+
+  // Next to the log by default
+  auto prefix = args.size() >= 2 ? args[1] : inputFilepath;
+  if (args.size() < 2)
+  {
+    const auto dot = prefix.find_last_of('.');
+    const auto separator = prefix.find_last_of("/\\");
+    if (dot != std::string::npos && (separator == std::string::npos || dot > separator))
+      prefix = prefix.substr(0, dot);
+  }
+
+  telemetry::LogReader reader(inputFilepath);
+
+  auto frames = OpenCsv(prefix + "_frames.csv",
+    "frame,start_ms,ui_ms,frames_ms,results_ms,render_ms,skipped,stream_count");
+  auto detections = OpenCsv(prefix + "_detections.csv",
+    "frame,stream,capture_ms,detection_start_ms,detection_end_ms,take_ms,marker_count,latency_ms");
+  auto poses = OpenCsv(prefix + "_poses.csv",
+    "frame,stream,marker_id,rvec_x,rvec_y,rvec_z,tvec_x,tvec_y,tvec_z");
+  poses << std::setprecision(9);
+
+  std::map<telemetry::RecordType, uint64_t> counts;
+  telemetry::RecordHeader header;
+  while (reader.Next(header))
+  {
+    counts[header.type]++;
+
+    switch (header.type)
+    {
+    case telemetry::RecordType::FRAME:
+    {
+      const auto record = reader.As<telemetry::FrameRecord>();
+      frames << record.frame << ','
+        << Milliseconds(record.startTime) << ','
+        << Milliseconds(record.uiTime) << ','
+        << Milliseconds(record.framesTime) << ','
+        << Milliseconds(record.resultsTime) << ','
+        << Milliseconds(record.renderTime) << ','
+        << record.skipped << ','
+        << record.streamCount << '\n';
+    }
+    break;
+
+    case telemetry::RecordType::DETECTION:
+    {
+      const auto record = reader.As<telemetry::DetectionRecord>();
+      detections << record.frame << ','
+        << record.stream << ','
+        << Milliseconds(record.captureTime) << ','
+        << Milliseconds(record.detectionStartTime) << ','
+        << Milliseconds(record.detectionEndTime) << ','
+        << Milliseconds(record.takeTime) << ','
+        << record.markerCount << ','
+        << Milliseconds(record.takeTime - record.captureTime) << '\n';
+    }
+    break;
+
+    case telemetry::RecordType::POSE:
+    {
+      const auto record = reader.As<telemetry::PoseRecord>();
+      poses << record.frame << ','
+        << record.stream << ','
+        << record.markerId << ','
+        << record.rvec[0] << ',' << record.rvec[1] << ',' << record.rvec[2] << ','
+        << record.tvec[0] << ',' << record.tvec[1] << ',' << record.tvec[2] << '\n';
+    }
+    break;
+
+    // Written by a newer version
+    default:
+      break;
+    }
+  }
+
+  for (const auto& count : counts)
+    std::cout << telemetry::ToString(count.first) << ": " << count.second << " records" << std::endl;
+  std::cout << "Written to " << prefix << "_{frames,detections,poses}.csv" << std::endl;
+
+  return 0;
+}
+}
+}
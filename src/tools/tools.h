@@ -0,0 +1,23 @@
+#ifndef GLAR_TOOLS_TOOLS_H_
+#define GLAR_TOOLS_TOOLS_H_
+
+#include <string>
+#include <vector>
+
+namespace glar
+{
+namespace tools
+{
+// Subcommands, args exclude the subcommand name. Return process exit code.
+int Autotune(const std::vector<std::string>& args);
+int MjpegServer(const std::vector<std::string>& args);
+
+// Reads the pose channel of a running glar and measures its latency, or publishes a synthetic one with --publish
+int ShmLatency(const std::vector<std::string>& args);
+
+// Converts a telemetry log of glar to CSV files of frames, detections and poses
+int TelemetryToCsv(const std::vector<std::string>& args);
+}
+}
+
+#endif // GLAR_TOOLS_TOOLS_H_